@@ -0,0 +1,36 @@
+#pragma once
+#include <cstdint>
+#include "frame_phase.h"
+
+namespace golxx {
+    // Building with GOLXX_TRACK_ALLOCATIONS, or any debug build, replaces the global operator new with one
+    // that counts allocations and their bytes against the phase the allocating thread is in.
+    // Otherwise nothing is counted and every figure reads 0.
+#if defined(GOLXX_TRACK_ALLOCATIONS) || !defined(NDEBUG)
+    constexpr bool ALLOCATION_TRACKING = true;
+#else
+    constexpr bool ALLOCATION_TRACKING = false;
+#endif
+
+    struct AllocationStats {
+        std::uint64_t count = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    // Totals since start, over every thread
+    [[nodiscard]] AllocationStats allocation_stats(FramePhase phase);
+    [[nodiscard]] AllocationStats allocation_stats();
+
+    // Attributes the calling thread's allocations to phase until destroyed, then restores the previous phase
+    class AllocationScope {
+    public:
+        explicit AllocationScope(FramePhase phase);
+        ~AllocationScope();
+
+        AllocationScope(const AllocationScope&) = delete;
+        AllocationScope& operator=(const AllocationScope&) = delete;
+
+    private:
+        FramePhase previous_;
+    };
+}
@@ -0,0 +1,180 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "cell_region.h"
+#include "glm_common.h"
+#include "life_kernels.h"
+#include "life_rule.h"
+#include "node_pool.h"
+#include "simulation_engine.h"
+#include "thread_pool.h"
+
+namespace golxx {
+    // Sparse universe made of 64x64 tiles, one uint64_t per tile row.
+    // Bit x of row y in tile (tx, ty) is the cell (tx * 64 + x, ty * 64 + y).
+    // Only tiles next to recent activity are stepped: still lifes and period-2 oscillators cost nothing.
+    class BitTileUniverse final : public SimulationEngine {
+    public:
+        static constexpr int TILE_SHIFT = 6;
+        static constexpr int TILE_SIZE = 1 << TILE_SHIFT;
+
+        using TileRows = std::array<std::uint64_t, TILE_SIZE>;
+        static_assert(TILE_SIZE == CellTile::SIZE);
+
+        BitTileUniverse();
+
+        // Steps tiles across the pool when set; the pool must outlive the universe
+        void set_thread_pool(ThreadPool* pool) {
+            pool_ = pool;
+        }
+
+        [[nodiscard]] SimulationEngineType getType() const override {
+            return SimulationEngineType::BitTile;
+        }
+
+        void set_rule(const LifeRule& rule) override;
+
+        void set_state(glm::i64vec2 cell, bool state) override;
+        [[nodiscard]] bool get_state(glm::i64vec2 cell) const;
+
+        // Sets every cell live, updating each touched tile once
+        void set_cells(const std::vector<glm::i64vec2>& cells) override;
+
+        // Steps one generation at a time, 2^exponent times
+        void step(unsigned int exponent) override;
+        void clear() override;
+
+        struct CellChanges {
+            std::uint64_t births = 0;
+            std::uint64_t deaths = 0;
+        };
+
+        // Cells born and died in the last step, valid until the next edit; walks every tile that may
+        // have changed, quiet oscillators included
+        [[nodiscard]] CellChanges last_changes() const;
+        [[nodiscard]] CellRegion bounds() const override;
+        // Estimated heap memory held by the tiles, the population pyramid and the step's work lists
+        [[nodiscard]] std::size_t memory_usage() const;
+
+        [[nodiscard]] std::uint64_t population() const override;
+        [[nodiscard]] std::size_t getTileCount() const {
+            return tiles_.size();
+        }
+
+        // Tiles whose neighborhood was examined by the last step
+        [[nodiscard]] std::size_t getActiveTileCount() const {
+            return visit_order_.size();
+        }
+
+        // Touches only the tiles that overlap region
+        void collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const override;
+
+        // Blocks of a tile or larger come from the population pyramid
+        void collect_density(const CellRegion& region, unsigned int shift,
+                             std::vector<DensityBlock>& blocks) const override;
+
+        // Visits the stored rows of every non-empty tile overlapping region, stamped with the step that last
+        // changed it rather than with stamp
+        void visit_tiles(const CellRegion& region, std::uint64_t stamp, const TileVisitor& visit) const override;
+
+        void set_stamp_base(const std::uint64_t base) override {
+            version_ = base;
+        }
+
+        [[nodiscard]] std::uint64_t getLastStamp() const override {
+            return version_;
+        }
+
+        void fill_stats(GenerationStats& stats) const override;
+
+    private:
+        // Activity flags describe the present generation and only ever err towards "changed".
+        // CHANGED: rows may differ from the previous generation.
+        // PERIOD2: rows equal the generation before the previous one.
+        // EDITED: rows were edited rather than produced by the rule, so the history says nothing.
+        enum Activity : std::uint8_t {
+            CHANGED = 1,
+            PERIOD2 = 2,
+            EDITED = 4,
+        };
+
+        // Two buffers per tile; current_ selects the one holding the present generation
+        // and the other one still holds the previous generation.
+        // Population, the mask of occupied borders and the stamp of the last write are kept per buffer;
+        // a buffer rewritten with the other one's contents takes its stamp, so still lifes keep theirs.
+        struct Tile {
+            TileRows rows[2]{};
+            std::uint64_t stamps[2]{};
+            std::uint16_t population[2]{};
+            std::uint8_t borders[2]{};
+            std::uint8_t activity = PERIOD2;
+            std::uint64_t visit_stamp = 0;
+        };
+
+        struct VisitedTile {
+            glm::i64vec2 key;
+            Tile* tile;
+            std::uint8_t activity;
+            std::int32_t population_delta;
+        };
+
+        // Population of 2^(level + 1) tile blocks, per buffer like the tiles themselves,
+        // so period-2 tiles that are never visited still read correctly
+        static constexpr int PYRAMID_LEVELS = 20;
+        static constexpr std::size_t SPARE_NODES = 1024;
+        using PyramidLevel = std::unordered_map<glm::i64vec2, std::array<std::uint64_t, 2>>;
+
+        struct PopulationDelta {
+            glm::i64vec2 key;
+            std::int64_t delta;
+        };
+
+        [[nodiscard]] const Tile* find_tile(glm::i64vec2 tile) const;
+
+        static void update_summary(Tile& tile, int buffer);
+
+        void mark_edited(glm::i64vec2 key, Tile& tile);
+        // Calls fn(key, tile) for every non-empty tile overlapping region
+        template <typename Fn>
+        void for_each_tile(const CellRegion& region, const Fn& fn) const;
+        void expand_border_tiles();
+        void collect_visits();
+        void step_generation();
+        [[nodiscard]] std::uint8_t step_tile(glm::i64vec2 key, Tile& tile) const;
+        void apply_visits();
+        [[nodiscard]] bool is_border_target(glm::i64vec2 key) const;
+
+        void add_population_delta(glm::i64vec2 key, std::int64_t delta);
+        void update_pyramid(int buffer);
+
+    private:
+        using TileMap = std::unordered_map<glm::i64vec2, Tile>;
+
+        TileMap tiles_;
+        int current_ = 0;
+
+        // Tiles die and get recreated all along a moving pattern's path; recycling their nodes keeps
+        // stepping free of heap allocations once the pattern has reached its size
+        NodePool<TileMap> tile_nodes_{SPARE_NODES};
+        NodePool<PyramidLevel> pyramid_nodes_{SPARE_NODES};
+
+        // Tiles lacking PERIOD2; their neighborhoods are the only ones the next step examines
+        std::vector<glm::i64vec2> hot_tiles_;
+        std::vector<glm::i64vec2> next_hot_tiles_;
+        std::vector<VisitedTile> visit_order_;
+        std::vector<glm::i64vec2> erase_candidates_;
+        std::vector<VisitedTile> edited_tiles_;
+
+        std::array<PyramidLevel, PYRAMID_LEVELS> pyramid_;
+        std::vector<PopulationDelta> population_deltas_;
+        std::uint64_t step_count_ = 0;
+        // Bumped by every step and edit; source of the tile stamps
+        std::uint64_t version_ = 0;
+
+        LifeRule rule_;
+        LifeRowsKernel step_rows_;
+        ThreadPool* pool_ = nullptr;
+    };
+}
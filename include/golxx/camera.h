@@ -1,10 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "cell_region.h"
 #include "glm_common.h"
 
 namespace golxx {
+    // The view is kept as a whole cell origin plus a float position relative to it, so floats only ever
+    // hold distances across the screen and keep single-cell precision anywhere in the cell range
     class Camera {
     public:
+        glm::i64vec2 origin{};
         glm::vec3 position{};
 
         Camera(const float zoom_level, const glm::vec2 size)
@@ -35,6 +42,16 @@ namespace golxx {
             update_projection();
         }
 
+        // Moves the whole cells of position into origin, leaving position within a cell of it; the view
+        // stops at the edge of the cell range
+        void rebase() {
+            const glm::i64vec2 rebased(offset_cell(origin.x, position.x), offset_cell(origin.y, position.y));
+            position.x = std::clamp(position.x - static_cast<float>(rebased.x - origin.x), 0.0f, 1.0f);
+            position.y = std::clamp(position.y - static_cast<float>(rebased.y - origin.y), 0.0f, 1.0f);
+            origin = rebased;
+        }
+
+        // Relative to origin
         [[nodiscard]] glm::vec2 cursor_to_world(const glm::vec2 cursor) const {
             const glm::vec4 ndcPos(
                 2.0f * cursor.x / static_cast<float>(size_.x) - 1.0f,
@@ -51,7 +68,26 @@ namespace golxx {
             return {worldPos.x, worldPos.y};
         }
 
+        [[nodiscard]] glm::i64vec2 cursor_to_cell(const glm::vec2 cursor) const {
+            const auto world = cursor_to_world(cursor);
+            return {offset_cell(origin.x, world.x), offset_cell(origin.y, world.y)};
+        }
+
+        // Cells touching the screen, found by unprojecting its corners; cell (x, y) covers [x, x + 1)
+        [[nodiscard]] CellRegion visible_region() const {
+            return {cursor_to_cell({0.0f, size_.y}), cursor_to_cell({size_.x, 0.0f})};
+        }
+
     private:
+        // The cell offset away from origin, clamped to the cell range
+        static std::int64_t offset_cell(const std::int64_t origin, const float offset) {
+            // Clamping the offset first keeps the sum from overflowing however far out the view is zoomed
+            constexpr auto LIMIT = static_cast<double>(2 * CELL_LIMIT);
+            const auto cells = static_cast<std::int64_t>(
+                std::clamp(std::floor(static_cast<double>(offset)), -LIMIT, LIMIT));
+            return std::clamp(origin + cells, -CELL_LIMIT, CELL_LIMIT - 1);
+        }
+
         void update_projection() {
             const auto aspect_ratio = size_.x / size_.y;
 
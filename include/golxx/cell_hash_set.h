@@ -0,0 +1,165 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+#include "glm_common.h"
+
+namespace golxx {
+    // Set of cells in one flat open-addressing table with Robin Hood probing: on insertion a cell takes the
+    // slot of any resident that sits closer to its home slot, which keeps every probe sequence short, and
+    // erasure shifts the run after it back by one instead of leaving tombstones. The table only ever grows;
+    // clear keeps it, so a set refilled to a similar size stops allocating.
+    class CellHashSet {
+    public:
+        // Inserting past this share of the slots doubles the table
+        static constexpr std::size_t MAX_LOAD_NUMERATOR = 3;
+        static constexpr std::size_t MAX_LOAD_DENOMINATOR = 4;
+        static constexpr std::size_t MIN_CAPACITY = 16;
+
+    private:
+        // distance is one more than the slot's offset from the cell's home slot; 0 marks an empty slot
+        struct Slot {
+            glm::i64vec2 cell;
+            std::uint32_t distance;
+        };
+
+    public:
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = glm::i64vec2;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const glm::i64vec2*;
+            using reference = const glm::i64vec2&;
+
+            Iterator(const Slot* slot, const Slot* end)
+                : slot_(slot),
+                  end_(end) {
+                skip_empty();
+            }
+
+            reference operator*() const {
+                return slot_->cell;
+            }
+
+            pointer operator->() const {
+                return &slot_->cell;
+            }
+
+            Iterator& operator++() {
+                ++slot_;
+                skip_empty();
+                return *this;
+            }
+
+            bool operator==(const Iterator& other) const {
+                return slot_ == other.slot_;
+            }
+
+            bool operator!=(const Iterator& other) const {
+                return slot_ != other.slot_;
+            }
+
+        private:
+            void skip_empty() {
+                while (slot_ != end_ && slot_->distance == 0) {
+                    ++slot_;
+                }
+            }
+
+            const Slot* slot_;
+            const Slot* end_;
+        };
+
+        CellHashSet() = default;
+
+        [[nodiscard]] Iterator begin() const {
+            return {slots_.data(), slots_.data() + slots_.size()};
+        }
+
+        [[nodiscard]] Iterator end() const {
+            return {slots_.data() + slots_.size(), slots_.data() + slots_.size()};
+        }
+
+        [[nodiscard]] std::size_t size() const {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] std::size_t capacity() const {
+            return slots_.size();
+        }
+
+        [[nodiscard]] bool contains(const glm::i64vec2 cell) const {
+            if (size_ == 0) {
+                return false;
+            }
+
+            // Residents are ordered by distance along a run, so the search ends at the first one closer to home
+            auto index = home(cell);
+            for (std::uint32_t distance = 1;; distance++) {
+                const auto& slot = slots_[index];
+                if (slot.distance < distance) {
+                    return false;
+                }
+                if (slot.distance == distance && slot.cell == cell) {
+                    return true;
+                }
+                index = (index + 1) & mask_;
+            }
+        }
+
+        // Returns whether cell was missing
+        bool insert(glm::i64vec2 cell);
+        // Returns whether cell was present
+        bool erase(glm::i64vec2 cell);
+
+        template <typename It>
+        void insert(It first, const It last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        // Makes room for count cells without growing on the way
+        void reserve(std::size_t count);
+
+        // Empties the set and keeps the table
+        void clear();
+
+        [[nodiscard]] std::size_t memory_usage() const {
+            return slots_.capacity() * sizeof(Slot);
+        }
+
+        // 64-bit finalizer over both coordinates, so neighboring cells land far apart; x is spread by an odd
+        // multiplier first so that it and y cannot cancel out
+        static std::uint64_t hash(const glm::i64vec2 cell) {
+            auto value = static_cast<std::uint64_t>(cell.x) * 0x9e3779b97f4a7c15ULL ^
+                static_cast<std::uint64_t>(cell.y);
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdULL;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ULL;
+            value ^= value >> 33;
+            return value;
+        }
+
+    private:
+        [[nodiscard]] std::size_t home(const glm::i64vec2 cell) const {
+            return static_cast<std::size_t>(hash(cell)) & mask_;
+        }
+
+        void rehash(std::size_t capacity);
+        void place(glm::i64vec2 cell);
+
+    private:
+        std::vector<Slot> slots_;
+        std::vector<Slot> old_slots_;
+        std::size_t mask_ = 0;
+        std::size_t size_ = 0;
+    };
+}
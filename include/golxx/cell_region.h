@@ -0,0 +1,77 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <limits>
+#include "glm_common.h"
+
+namespace golxx {
+    // Cells live in [-CELL_LIMIT, CELL_LIMIT) on both axes, which leaves room to add offsets and neighbor
+    // distances to any cell coordinate without overflowing 64 bits
+    constexpr std::int64_t CELL_LIMIT = std::int64_t{1} << 60;
+
+    [[nodiscard]] constexpr bool in_cell_range(const glm::i64vec2 cell) {
+        return cell.x >= -CELL_LIMIT && cell.x < CELL_LIMIT && cell.y >= -CELL_LIMIT && cell.y < CELL_LIMIT;
+    }
+
+    // Axis-aligned rectangle of cells, both corners inclusive
+    struct CellRegion {
+        glm::i64vec2 min{};
+        glm::i64vec2 max{-1, -1};
+
+        [[nodiscard]] bool empty() const {
+            return max.x < min.x || max.y < min.y;
+        }
+
+        [[nodiscard]] bool contains(const glm::i64vec2 cell) const {
+            return cell.x >= min.x && cell.x <= max.x && cell.y >= min.y && cell.y <= max.y;
+        }
+
+        [[nodiscard]] bool intersects(const CellRegion& other) const {
+            return !empty() && !other.empty() &&
+                min.x <= other.max.x && other.min.x <= max.x && min.y <= other.max.y && other.min.y <= max.y;
+        }
+
+        // Saturates at the largest uint64 for regions spanning most of the cell range
+        [[nodiscard]] std::uint64_t area() const {
+            if (empty()) {
+                return 0;
+            }
+            const auto width = static_cast<std::uint64_t>(max.x) - static_cast<std::uint64_t>(min.x) + 1;
+            const auto height = static_cast<std::uint64_t>(max.y) - static_cast<std::uint64_t>(min.y) + 1;
+            if (width != 0 && height > std::numeric_limits<std::uint64_t>::max() / width) {
+                return std::numeric_limits<std::uint64_t>::max();
+            }
+            return width * height;
+        }
+
+        bool operator==(const CellRegion& other) const {
+            return min == other.min && max == other.max;
+        }
+
+        bool operator!=(const CellRegion& other) const {
+            return !(*this == other);
+        }
+
+        // The region covering every 2^shift x 2^shift block this one touches, in block coordinates
+        [[nodiscard]] CellRegion blocks(const unsigned int shift) const {
+            return {{min.x >> shift, min.y >> shift}, {max.x >> shift, max.y >> shift}};
+        }
+    };
+
+    // A 64x64 square of cells, one bit per cell: bit x of row y is the cell key * 64 + (x, y).
+    // stamp changes whenever the rows do, so a copy taken under the same stamp is still current.
+    struct CellTile {
+        static constexpr int SHIFT = 6;
+        static constexpr int SIZE = 1 << SHIFT;
+
+        glm::i64vec2 key;
+        std::uint64_t stamp;
+        std::array<std::uint64_t, SIZE> rows;
+    };
+
+    // Live cells inside the 2^shift x 2^shift block at block * 2^shift
+    struct DensityBlock {
+        glm::i64vec2 block;
+        std::uint64_t population;
+    };
+}
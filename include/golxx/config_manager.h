@@ -14,6 +14,16 @@ namespace golxx {
 
         // Player movement
         float playerSpeed = 50.0f;
+
+        // Simulation settings, 0 threads uses every hardware thread
+        int simulationThreads = 0;
+        // Target speed while running, 0 steps as fast as possible
+        float generationsPerSecond = 60.0f;
+        // Life-like rule in B/S notation
+        std::string rule = "B3/S23";
+        // Simulation engine: "hashset", "bittile", "hashlife" or "sorted", or "auto" to let the simulator
+        // pick and switch
+        std::string engine = "bittile";
     };
 
     class ConfigManager {
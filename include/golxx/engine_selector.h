@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "cell_region.h"
+#include "simulation_engine.h"
+
+namespace golxx {
+    // Samples a universe every SAMPLE_INTERVAL generations and proposes the engine likely to step it fastest:
+    // - HashLife when many tiles are copies of each other, or the bounding box keeps growing while some
+    //   are, and the caller is about to run enough generations for jumps to pay off
+    // - HashLife as well when the population is small and the caller is about to run far more generations
+    //   than stepping one by one could cover
+    // - the sorted engine when the population is spread so thinly that tiles hold a few cells on average
+    // - the tile engine otherwise
+    // A proposal has to come up on CONFIRMATIONS samples in a row, so a pattern near a threshold does
+    // not bounce between engines.
+    class EngineSelector {
+    public:
+        static constexpr std::uint64_t SAMPLE_INTERVAL = 256;
+        static constexpr int CONFIRMATIONS = 2;
+
+        // Tiles are not binned past this population; the universe is only ever handed to HashLife then
+        static constexpr std::uint64_t MAX_SAMPLED_POPULATION = std::uint64_t{1} << 22;
+
+        // Returns the engine to migrate to, if any. generations_ahead is how far the caller is about to
+        // run, which decides whether HashLife's jumps can make up for its slower single generations.
+        std::optional<SimulationEngineType> sample(const SimulationEngine& engine, std::uint64_t generation,
+                                                   std::uint64_t generations_ahead);
+
+        // Why the last proposal was made, for logging
+        [[nodiscard]] const std::string& getReason() const {
+            return reason_;
+        }
+
+        // Forgets the history, e.g. after the universe was replaced
+        void reset();
+
+    private:
+        std::uint64_t next_sample_ = 0;
+        std::uint64_t previous_area_ = 0;
+        std::optional<SimulationEngineType> candidate_;
+        int confirmations_ = 0;
+        std::string reason_;
+    };
+}
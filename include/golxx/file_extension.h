@@ -0,0 +1,17 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+namespace golxx {
+    // Whether filename ends in extension, which must be given in lower case; the filename's case is ignored
+    inline bool has_extension(const std::string& filename, const std::string& extension) {
+        if (filename.size() < extension.size()) {
+            return false;
+        }
+
+        return std::equal(extension.rbegin(), extension.rend(), filename.rbegin(), [](const char a, const char b) {
+            return a == std::tolower(static_cast<unsigned char>(b));
+        });
+    }
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstddef>
+
+namespace golxx {
+    // Parts of a frame, in the order Game::run goes through them. Render covers Upload and Draw;
+    // Step runs on the simulation thread alongside the others. The Gpu phases are GPU time, measured
+    // with timer queries and reported a few frames late.
+    enum class FramePhase {
+        Other,
+        Poll,
+        Input,
+        Update,
+        Step,
+        Render,
+        Upload,
+        Draw,
+        Swap,
+        GpuClear,
+        GpuUpload,
+        GpuDraw,
+        Count,
+    };
+
+    constexpr auto FRAME_PHASE_COUNT = static_cast<std::size_t>(FramePhase::Count);
+
+    const char* to_string(FramePhase phase);
+}
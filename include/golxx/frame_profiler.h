@@ -0,0 +1,98 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+#include "allocation_tracker.h"
+#include "frame_phase.h"
+#include "trace_recorder.h"
+
+namespace golxx {
+    // Times the phases of every frame. Scopes on any thread add to the phase totals of the frame in
+    // progress; end_frame closes it into a ring buffer of the last HISTORY frames, from which the
+    // percentiles are taken. Recording allocates nothing.
+    class FrameProfiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr std::size_t HISTORY = 1024;
+
+        struct FrameRecord {
+            double seconds = 0.0;
+            std::array<double, FRAME_PHASE_COUNT> phases{};
+        };
+
+        struct Percentiles {
+            double p50 = 0.0;
+            double p95 = 0.0;
+            double p99 = 0.0;
+            double max = 0.0;
+        };
+
+        static FrameProfiler& get();
+
+        void add(FramePhase phase, Clock::duration elapsed);
+
+        // Closes the frame in progress and once a second prints FPS, frame time percentiles and, when
+        // allocations are tracked, the allocations per frame of every phase that made any
+        void end_frame();
+
+        // Over the frames in the ring buffer, in seconds
+        [[nodiscard]] Percentiles frame_percentiles() const;
+        [[nodiscard]] Percentiles phase_percentiles(FramePhase phase) const;
+
+        // Percentiles of every phase as a table
+        void dump(std::ostream& out) const;
+        // The ring buffer as CSV, oldest frame first, times in milliseconds
+        void write_history(std::ostream& out) const;
+
+    private:
+        FrameProfiler();
+
+        template <typename Value>
+        [[nodiscard]] Percentiles percentiles(const Value& value) const;
+
+        void print_summary(double seconds);
+
+    private:
+        std::array<std::atomic<std::int64_t>, FRAME_PHASE_COUNT> pending_{};
+        std::vector<FrameRecord> history_;
+        std::size_t next_ = 0;
+        std::size_t size_ = 0;
+        Clock::time_point frame_start_;
+
+        Clock::time_point summary_start_;
+        unsigned int summary_frames_ = 0;
+        std::array<AllocationStats, FRAME_PHASE_COUNT> summary_allocations_{};
+
+        mutable std::vector<double> scratch_;
+    };
+
+    // Adds the time until it is destroyed to phase, attributes the thread's allocations meanwhile to it
+    // and, while a trace is recorded, adds it as a span
+    class ProfileScope {
+    public:
+        explicit ProfileScope(const FramePhase phase)
+            : phase_(phase),
+              allocation_scope_(phase),
+              start_(FrameProfiler::Clock::now()) {}
+
+        ~ProfileScope() {
+            const auto end = FrameProfiler::Clock::now();
+            FrameProfiler::get().add(phase_, end - start_);
+            if (auto& trace = TraceRecorder::get(); trace.recording()) {
+                trace.add_span(to_string(phase_), "frame", start_, end);
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        FramePhase phase_;
+        AllocationScope allocation_scope_;
+        FrameProfiler::Clock::time_point start_;
+    };
+}
@@ -1,15 +1,21 @@
 #pragma once
 
+#include <string>
 #include "application.h"
 #include "camera.h"
 #include "engine.h"
 #include "game_object.h"
+#include "gpu_timer.h"
+#include "simulation_worker.h"
 #include "simulator.h"
 
 namespace golxx {
     class Game {
     public:
-        Game(Application& application, Engine& engine);
+        // pattern_file is loaded on start when given, and is where F5 saves and F9 reloads from.
+        // simulation_engine overrides the engine named in config.json when given.
+        Game(Application& application, Engine& engine, const std::string& pattern_file = "",
+             const std::string& simulation_engine = "");
 
         ~Game();
 
@@ -19,13 +25,26 @@ namespace golxx {
         void update(float deltaTime);
         void render();
 
+        void save_pattern();
+        void reload_pattern();
+
+        // Prints frame phase percentiles and writes the frames behind them to a CSV file
+        void dump_profile();
+        // Starts recording a Chrome trace, or stops and writes the one being recorded
+        void toggle_trace();
+        // Starts or stops streaming per-generation statistics from the simulation thread to a CSV file
+        void toggle_generation_stats();
+
     private:
         Application& application_;
         Engine& engine_;
         glfw::Window& window_;
+        std::string pattern_file_;
 
         std::shared_ptr<Simulator> simulator_;
+        std::shared_ptr<SimulationWorker> simulation_worker_;
         std::shared_ptr<Camera> camera_;
+        std::shared_ptr<GpuTimer> gpu_timer_;
         std::vector<std::shared_ptr<GameObject>> gameObjects_;
     };
 }
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include "cell_region.h"
+
+namespace golxx {
+    // What one step of the simulator did. A step is a single generation except on the HashLife engine,
+    // which jumps 2^exponent generations at once and cannot tell births from deaths along the way.
+    struct GenerationStats {
+        // Generation reached by the step, and how many generations it covered
+        std::uint64_t generation = 0;
+        std::uint64_t generations = 1;
+        std::uint64_t population = 0;
+        std::optional<std::uint64_t> births;
+        std::optional<std::uint64_t> deaths;
+        // Smallest rectangle holding every live cell; empty when nothing lives
+        CellRegion bounds;
+        // Tiles the tile engine examined; 0 on the other engines
+        std::uint64_t active_tiles = 0;
+        double step_seconds = 0.0;
+        // Estimated heap memory held by the engine
+        std::size_t memory_bytes = 0;
+    };
+
+    // Rough heap footprint of a std::unordered_map or std::unordered_set: a node per element holding
+    // the value, the next pointer and the cached hash, plus the bucket array
+    template <typename Container>
+    [[nodiscard]] std::size_t hash_container_memory(const Container& container) {
+        return container.size() * (sizeof(typename Container::value_type) + sizeof(void*) + sizeof(std::size_t)) +
+            container.bucket_count() * sizeof(void*);
+    }
+
+    // Streams GenerationStats to a file, one line per step. The format follows the extension: ".ndjson"
+    // and ".jsonl" give a JSON object per line, anything else CSV with a header row. Unknown values are
+    // left empty in CSV and null in JSON.
+    class GenerationStatsWriter {
+    public:
+        // Throws std::runtime_error when the file cannot be opened
+        explicit GenerationStatsWriter(const std::string& filename);
+
+        void write(const GenerationStats& stats);
+
+        [[nodiscard]] const std::string& getFilename() const {
+            return filename_;
+        }
+
+    private:
+        void write_csv(const GenerationStats& stats);
+        void write_json(const GenerationStats& stats);
+
+    private:
+        std::string filename_;
+        std::ofstream out_;
+        bool json_;
+    };
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "frame_phase.h"
+#include "gl_common.h"
+
+namespace golxx {
+    // Times GPU work with GL_TIME_ELAPSED queries and adds the results to the frame profiler. A query is
+    // read LATENCY frames after it was issued, when the GPU has long finished it, so reading never stalls;
+    // the GPU phases of a frame record therefore belong to the frame LATENCY frames earlier.
+    class GpuTimer {
+    public:
+        static constexpr std::size_t LATENCY = 4;
+
+        GpuTimer() = default;
+        ~GpuTimer();
+
+        GpuTimer(const GpuTimer&) = delete;
+        GpuTimer& operator=(const GpuTimer&) = delete;
+
+        // GL allows a single time query at a time, so begin returns false and times nothing while one runs
+        bool begin(FramePhase phase);
+        void end();
+
+        // Adds the queries of the frame issued LATENCY frames ago to the frame profiler; queries the GPU
+        // has still not finished by then are dropped rather than waited for
+        void end_frame();
+
+    private:
+        struct Query {
+            GLuint id;
+            FramePhase phase;
+        };
+
+        // The frame being issued plus the LATENCY frames in flight behind it
+        std::array<std::vector<Query>, LATENCY + 1> frames_;
+        std::size_t frame_ = 0;
+        std::vector<GLuint> free_queries_;
+        bool running_ = false;
+    };
+
+    // Times the GPU commands issued until it is destroyed as phase; an inner scope is ignored
+    class GpuTimerScope {
+    public:
+        GpuTimerScope(GpuTimer& timer, const FramePhase phase)
+            : timer_(timer),
+              started_(timer.begin(phase)) {}
+
+        ~GpuTimerScope() {
+            if (started_) {
+                timer_.end();
+            }
+        }
+
+        GpuTimerScope(const GpuTimerScope&) = delete;
+        GpuTimerScope& operator=(const GpuTimerScope&) = delete;
+
+    private:
+        GpuTimer& timer_;
+        bool started_;
+    };
+}
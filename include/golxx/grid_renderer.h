@@ -1,20 +1,39 @@
 #pragma once
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "camera.h"
 #include "game_object.h"
-#include "simulator.h"
+#include "gpu_timer.h"
+#include "simulation_worker.h"
 #include "gl_common.h"
+#include "node_pool.h"
 
 namespace golxx {
+    // Positions are relative to the corner of the snapshot's region
+    struct CellInstanceData {
+        glm::vec2 position;
+    };
+
+    struct TileInstanceData {
+        glm::vec2 origin;
+        float slot;
+    };
+
     class GridRenderer final : public GameObject {
     public:
-        explicit GridRenderer(const std::shared_ptr<Simulator>& simulator,
-                              const glm::vec3& live_cell_color)
-            : simulator_(simulator),
-              live_cell_color_(live_cell_color) {}
+        GridRenderer(const std::shared_ptr<SimulationWorker>& simulation_worker,
+                     const std::shared_ptr<GpuTimer>& gpu_timer,
+                     const glm::vec3& live_cell_color,
+                     const glm::vec3& background_color)
+            : simulation_worker_(simulation_worker),
+              gpu_timer_(gpu_timer),
+              live_cell_color_(live_cell_color),
+              background_color_(background_color) {}
 
-        ~GridRenderer() override = default;
+        ~GridRenderer() override;
 
         void init() override;
 
@@ -25,6 +44,21 @@ namespace golxx {
     private:
         void init_mesh();
         void init_shaders();
+        void init_bitmap_texture();
+        void init_tile_atlas();
+
+        // Instanced quads cost per live cell while tiles cost a bit per visible cell;
+        // zoomed out past a pixel per cell only the density bitmap is left
+        [[nodiscard]] SnapshotFormat choose_format(const SimulationSnapshot& snapshot, const CellRegion& region) const;
+
+        // Each path draws relative to a corner of the snapshot and places that corner against the camera
+        void render_cells(const std::shared_ptr<const SimulationSnapshot>& snapshot, const Camera& camera);
+        void render_bitmap(const std::shared_ptr<const SimulationSnapshot>& snapshot, const Camera& camera);
+        void render_tiles(const std::shared_ptr<const SimulationSnapshot>& snapshot, const Camera& camera);
+
+        // Uploads the tiles whose stamp differs from the copy already in the atlas and frees the slots
+        // of tiles that left the snapshot; returns the number of tiles uploaded
+        std::int64_t update_tile_atlas(const SimulationSnapshot& snapshot);
 
     private:
         std::unique_ptr<glad::VertexArray> vertex_array_;
@@ -33,8 +67,45 @@ namespace golxx {
         std::unique_ptr<glad::ElementArrayBuffer> element_array_buffer_;
         std::unique_ptr<glad::Program> shader_program_;
 
-        std::shared_ptr<Simulator> simulator_;
+        // A single quad textured with the visible region
+        std::unique_ptr<glad::VertexArray> bitmap_vertex_array_;
+        std::unique_ptr<glad::Program> bitmap_shader_program_;
+        GLuint bitmap_texture_ = 0;
+        glm::ivec2 bitmap_texture_size_{};
+        std::shared_ptr<const SimulationSnapshot> bitmap_snapshot_;
+        // Snapshot whose cells the instance buffer holds
+        std::shared_ptr<const SimulationSnapshot> cells_snapshot_;
+        std::vector<CellInstanceData> cell_instances_;
+
+        // Tiles stay resident in an atlas of 64x64 bit slots, keyed by tile and re-uploaded only
+        // when the simulation stamped them with a change
+        static constexpr std::size_t TILE_SLOT_NODES = 2048;
+
+        struct TileSlot {
+            GLuint index;
+            std::uint64_t stamp;
+            std::uint64_t epoch;
+        };
+
+        std::unique_ptr<glad::VertexArray> tile_vertex_array_;
+        std::unique_ptr<glad::ArrayBuffer> tile_instance_buffer_;
+        std::unique_ptr<glad::Program> tile_shader_program_;
+        GLuint tile_texture_ = 0;
+        using TileSlotMap = std::unordered_map<glm::i64vec2, TileSlot>;
+
+        TileSlotMap tile_slots_;
+        NodePool<TileSlotMap> tile_slot_nodes_{TILE_SLOT_NODES};
+        std::vector<GLuint> free_tile_slots_;
+        std::uint64_t tile_epoch_ = 0;
+        std::shared_ptr<const SimulationSnapshot> tiles_snapshot_;
+        std::vector<TileInstanceData> tile_instances_;
+        GLsizei tile_instance_count_ = 0;
+
+        std::shared_ptr<SimulationWorker> simulation_worker_;
+        std::shared_ptr<GpuTimer> gpu_timer_;
+        SnapshotFormat format_ = SnapshotFormat::Cells;
 
         glm::vec3 live_cell_color_;
+        glm::vec3 background_color_;
     };
 }
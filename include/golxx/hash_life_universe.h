@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "cell_region.h"
+#include "glm_common.h"
+#include "life_rule.h"
+#include "simulation_engine.h"
+
+namespace golxx {
+    // HashLife: the universe is a canonicalized quadtree whose nodes memoize their future,
+    // so a single step can advance 2^exponent generations.
+    // The root is always centered on the origin and grows no further than the cell range, CELL_LIMIT.
+    class HashLifeUniverse final : public SimulationEngine {
+    public:
+        HashLifeUniverse();
+
+        [[nodiscard]] SimulationEngineType getType() const override {
+            return SimulationEngineType::HashLife;
+        }
+
+        void set_rule(const LifeRule& rule) override;
+
+        void set_state(glm::i64vec2 cell, bool state) override;
+        [[nodiscard]] bool get_state(glm::i64vec2 cell) const;
+
+        // Sets every cell live, rebuilding each touched node once instead of once per cell
+        void set_cells(const std::vector<glm::i64vec2>& cells) override;
+
+        // Advances the universe by 2^exponent generations in one go
+        void step(unsigned int exponent) override;
+        void clear() override;
+
+        [[nodiscard]] unsigned int getMaxStepExponent() const override {
+            return MAX_STEP_EXPONENT;
+        }
+
+        [[nodiscard]] std::uint64_t population() const override;
+        [[nodiscard]] std::size_t getNodeCount() const {
+            return nodes_.size();
+        }
+
+        [[nodiscard]] CellRegion bounds() const override;
+        // Estimated heap memory held by the nodes and their index
+        [[nodiscard]] std::size_t memory_usage() const;
+
+        // Skips nodes that do not overlap region
+        void collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const override;
+
+        // Straight from the node populations
+        void collect_density(const CellRegion& region, unsigned int shift,
+                             std::vector<DensityBlock>& blocks) const override;
+
+        // Births and deaths are lost inside a jump, so only bounds and memory are known
+        void fill_stats(GenerationStats& stats) const override;
+
+    private:
+        using NodeId = std::uint32_t;
+
+        static constexpr NodeId NO_NODE = UINT32_MAX;
+        static constexpr NodeId DEAD_LEAF = 0;
+        static constexpr NodeId LIVE_LEAF = 1;
+
+        // Children are stored row-major with y growing downwards: nw, ne, sw, se
+        struct Node {
+            NodeId nw, ne, sw, se;
+            std::uint64_t population;
+            NodeId result;
+            std::int8_t result_exponent;
+            std::uint8_t level;
+        };
+
+        struct NodeKey {
+            NodeId nw, ne, sw, se;
+
+            bool operator==(const NodeKey& other) const {
+                return nw == other.nw && ne == other.ne && sw == other.sw && se == other.se;
+            }
+        };
+
+        struct NodeKeyHash {
+            std::size_t operator()(const NodeKey& key) const;
+        };
+
+        NodeId join(NodeId nw, NodeId ne, NodeId sw, NodeId se);
+        NodeId empty_node(unsigned int level);
+        NodeId centre(NodeId id);
+        [[nodiscard]] bool is_padded(NodeId id) const;
+
+        NodeId successor(NodeId id, unsigned int exponent);
+        NodeId step_base(NodeId id);
+
+        NodeId set_cell(NodeId id, std::int64_t x, std::int64_t y, bool state);
+
+        using CellIterator = std::vector<glm::i64vec2>::iterator;
+        NodeId set_cells(NodeId id, std::int64_t x, std::int64_t y, CellIterator begin, CellIterator end);
+        void collect_cells(NodeId id, std::int64_t x, std::int64_t y, const CellRegion& region,
+                           std::vector<glm::i64vec2>& cells) const;
+        void collect_density(NodeId id, std::int64_t x, std::int64_t y, const CellRegion& region, unsigned int shift,
+                             std::vector<DensityBlock>& blocks) const;
+        void extend_bounds(NodeId id, std::int64_t x, std::int64_t y, CellRegion& bounds) const;
+
+        [[nodiscard]] std::int64_t half_extent() const;
+
+        void collect_garbage();
+        NodeId copy_reachable(NodeId id, std::vector<NodeId>& remap, const std::vector<Node>& old_nodes);
+
+    private:
+        std::vector<Node> nodes_;
+        std::unordered_map<NodeKey, NodeId, NodeKeyHash> index_;
+        std::vector<NodeId> empty_nodes_;
+        std::vector<glm::i64vec2> cell_buffer_;
+        NodeId root_;
+        std::size_t collect_threshold_;
+        LifeRule rule_;
+    };
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "cell_hash_set.h"
+#include "simulation_engine.h"
+
+namespace golxx {
+    // The live cells in a hash set; each generation visits every live cell and its neighbors.
+    // Cost follows the population alone, which suits a few sparse objects spread far apart.
+    class HashSetEngine final : public SimulationEngine {
+    public:
+        [[nodiscard]] SimulationEngineType getType() const override {
+            return SimulationEngineType::HashSet;
+        }
+
+        void set_rule(const LifeRule& rule) override {
+            rule_ = rule;
+        }
+
+        void set_state(glm::i64vec2 cell, bool state) override;
+        void set_cells(const std::vector<glm::i64vec2>& cells) override;
+        void clear() override;
+
+        void step(unsigned int exponent) override;
+
+        [[nodiscard]] std::uint64_t population() const override {
+            return cells_.size();
+        }
+
+        [[nodiscard]] CellRegion bounds() const override;
+
+        void collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const override;
+        void collect_density(const CellRegion& region, unsigned int shift,
+                             std::vector<DensityBlock>& blocks) const override;
+
+        void fill_stats(GenerationStats& stats) const override;
+
+    private:
+        void step_generation();
+
+    private:
+        CellHashSet cells_;
+        // Each generation is applied as births and deaths within the same table, which stays allocated
+        std::vector<glm::i64vec2> births_;
+        std::vector<glm::i64vec2> deaths_;
+        LifeRule rule_;
+    };
+}
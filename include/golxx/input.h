@@ -1,7 +1,5 @@
 #pragma once
 
-#include <map>
-#include <queue>
 #include "gl_common.h"
 #include "glm_common.h"
 
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include "life_rule.h"
+
+namespace golxx {
+    // Steps the 64 rows of a tile by one generation. Inputs hold 66 rows, the tile plus the row
+    // below and above it; left/right are the center rows shifted so bit x holds the cell at x - 1 / x + 1.
+    // birth/survival are the rule masks; kernels specialized for a rule ignore them.
+    using LifeRowsKernel = void (*)(const std::uint64_t* left,
+                                    const std::uint64_t* center,
+                                    const std::uint64_t* right,
+                                    std::uint64_t* out,
+                                    std::uint16_t birth,
+                                    std::uint16_t survival);
+
+    struct LifeKernel {
+        const char* name;
+        LifeRowsKernel step_rows;
+    };
+
+    // Widest kernel the CPU supports, picked via CPUID on first use, and specialized
+    // for the rule when it is one of the common ones
+    LifeKernel get_life_kernel(const LifeRule& rule);
+}
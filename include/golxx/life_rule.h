@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+namespace golxx {
+    // Life-like rule: bit n of birth/survival is set when a cell with n live neighbors is born/survives
+    struct LifeRule {
+        std::uint16_t birth = 1 << 3;
+        std::uint16_t survival = 1 << 2 | 1 << 3;
+
+        // Accepts "B3/S23" notation (case insensitive, either order) and the legacy "23/3" survival/birth form.
+        // Throws std::invalid_argument on malformed rules and on B0 rules, which need an infinite background.
+        static LifeRule parse(const std::string& text);
+
+        [[nodiscard]] std::string to_string() const;
+
+        [[nodiscard]] bool next_state(const bool alive, const int neighbors) const {
+            return ((alive ? survival : birth) >> neighbors) & 1;
+        }
+
+        bool operator==(const LifeRule& other) const {
+            return birth == other.birth && survival == other.survival;
+        }
+
+        bool operator!=(const LifeRule& other) const {
+            return !(*this == other);
+        }
+    };
+}
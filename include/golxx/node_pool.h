@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace golxx {
+    // Keeps the nodes of erased elements of a node-based container (std::unordered_map, std::unordered_set)
+    // and hands them back on insertion, so a container whose size only wobbles stops allocating.
+    // At most limit nodes are kept; past that, erased nodes are freed as usual.
+    template <typename Container>
+    class NodePool {
+    public:
+        using Key = typename Container::key_type;
+        using Iterator = typename Container::iterator;
+
+        explicit NodePool(const std::size_t limit)
+            : limit_(limit) {}
+
+        // Like try_emplace with no arguments for maps and insert for sets; a new map value is value-initialized
+        std::pair<Iterator, bool> emplace(Container& container, const Key& key) {
+            if (const auto it = container.find(key); it != container.end()) {
+                return {it, false};
+            }
+
+            if (nodes_.empty()) {
+                if constexpr (IS_MAP) {
+                    return container.try_emplace(key);
+                }
+                else {
+                    return container.insert(key);
+                }
+            }
+
+            auto node = std::move(nodes_.back());
+            nodes_.pop_back();
+            if constexpr (IS_MAP) {
+                node.key() = key;
+                node.mapped() = typename Container::mapped_type{};
+            }
+            else {
+                node.value() = key;
+            }
+
+            const auto result = container.insert(std::move(node));
+            return {result.position, true};
+        }
+
+        void erase(Container& container, const Key& key) {
+            keep(container.extract(key));
+        }
+
+        // Returns the iterator following it, like Container::erase
+        Iterator erase(Container& container, const Iterator it) {
+            auto next = std::next(it);
+            keep(container.extract(it));
+            return next;
+        }
+
+        void clear() {
+            nodes_.clear();
+        }
+
+    private:
+        void keep(typename Container::node_type node) {
+            if (node && nodes_.size() < limit_) {
+                nodes_.push_back(std::move(node));
+            }
+        }
+
+        static constexpr bool IS_MAP = !std::is_same_v<typename Container::key_type, typename Container::value_type>;
+
+        std::vector<typename Container::node_type> nodes_;
+        std::size_t limit_;
+    };
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <istream>
+#include <ostream>
+#include <string>
+#include "simulator.h"
+
+namespace golxx {
+    // Pattern files are placed with their top-left cell at the origin and rows going down, unless an
+    // RLE file carries a "#CXRLE Pos=x,y" line. All functions throw std::runtime_error on bad input or I/O failure.
+
+    // Picks the format from the extension: ".rle" is RLE, anything else plaintext
+    void load_pattern(const std::string& filename, Simulator& simulator);
+    void save_pattern(const std::string& filename, const Simulator& simulator);
+
+    // Plaintext (.cells): lines starting with '!' are comments, 'O' or '*' is a live cell and anything else is dead
+    void read_plaintext(std::istream& in, Simulator& simulator);
+    void write_plaintext(std::ostream& out, const Simulator& simulator);
+
+    // RLE with an "x = , y = , rule =" header. Runs are decoded in fixed-size batches straight into
+    // the simulator, so memory use does not grow with the file. A rule in the header replaces the simulator's.
+    void read_rle(std::istream& in, Simulator& simulator);
+    void write_rle(std::ostream& out, const Simulator& simulator);
+}
@@ -3,29 +3,29 @@
 
 #include "camera.h"
 #include "game_object.h"
-#include "simulator.h"
+#include "simulation_worker.h"
 
 namespace golxx {
     class Player final : public GameObject {
     public:
         explicit Player(const std::shared_ptr<Camera>& camera,
-                        const std::shared_ptr<Simulator>& simulator,
+                        const std::shared_ptr<SimulationWorker>& simulation_worker,
                         float speed);
         ~Player() override = default;
 
         void update(float deltaTime) override;
 
     private:
-        void toggle_line_cells(glm::ivec2 from, glm::ivec2 to, bool toggle);
+        void toggle_line_cells(glm::i64vec2 from, glm::i64vec2 to, bool toggle);
 
     private:
         std::shared_ptr<Camera> camera_;
-        std::shared_ptr<Simulator> simulator_;
+        std::shared_ptr<SimulationWorker> simulation_worker_;
 
         float speed_;
 
         bool is_drawing_line_ = false;
         bool drawing_state_ = false;
-        glm::ivec2 last_cell_{};
+        glm::i64vec2 last_cell_{};
     };
 }
@@ -0,0 +1,93 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "cell_region.h"
+#include "generation_stats.h"
+#include "glm_common.h"
+#include "life_rule.h"
+#include "thread_pool.h"
+
+namespace golxx {
+    enum class SimulationEngineType {
+        HashSet,
+        BitTile,
+        HashLife,
+        SortedCells,
+    };
+
+    // Engine names as written in config.json and on the command line: "hashset", "bittile", "hashlife" and "sorted".
+    // Throws std::invalid_argument for unknown names.
+    SimulationEngineType parse_simulation_engine(const std::string& name);
+    const char* to_string(SimulationEngineType engine);
+
+    // A Life algorithm and the universe it steps. Simulator drives one of these and keeps everything
+    // that does not depend on the algorithm: generation count, step size, stamps and statistics.
+    class SimulationEngine {
+    public:
+        static constexpr unsigned int MAX_STEP_EXPONENT = 48;
+
+        virtual ~SimulationEngine() = default;
+
+        [[nodiscard]] virtual SimulationEngineType getType() const = 0;
+
+        virtual void set_rule(const LifeRule& rule) = 0;
+        virtual void set_state(glm::i64vec2 cell, bool state) = 0;
+        // Sets every cell live, updating the engine's storage once rather than once per cell
+        virtual void set_cells(const std::vector<glm::i64vec2>& cells) = 0;
+        virtual void clear() = 0;
+
+        // Advances 2^exponent generations
+        virtual void step(unsigned int exponent) = 0;
+
+        // Largest exponent a single step handles at once. Engines that step generation by generation
+        // return 0, and are then stepped once per generation so every generation can be observed.
+        [[nodiscard]] virtual unsigned int getMaxStepExponent() const {
+            return 0;
+        }
+
+        [[nodiscard]] virtual std::uint64_t population() const = 0;
+        // Smallest region holding every live cell; empty when nothing lives
+        [[nodiscard]] virtual CellRegion bounds() const = 0;
+
+        // Appends the live cells inside region
+        virtual void collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const = 0;
+
+        // Appends the population of the 2^shift x 2^shift blocks overlapping region; a block may appear
+        // more than once, in which case its populations add up
+        virtual void collect_density(const CellRegion& region, unsigned int shift,
+                                     std::vector<DensityBlock>& blocks) const = 0;
+
+        using TileVisitor = std::function<void(glm::i64vec2 key, std::uint64_t stamp,
+                                               const std::array<std::uint64_t, CellTile::SIZE>& rows)>;
+
+        // Calls visit for every non-empty 64x64 tile overlapping region, without keeping a copy of the tiles;
+        // rows are only valid during the call. Engines without tiles of their own bin their cells and give
+        // every tile stamp, which must change whenever any cell does.
+        virtual void visit_tiles(const CellRegion& region, std::uint64_t stamp, const TileVisitor& visit) const;
+
+        // Appends the tiles visit_tiles would visit
+        void collect_tiles(const CellRegion& region, std::uint64_t stamp, std::vector<CellTile>& tiles) const;
+
+        // Engines that stamp tiles on their own count on from base, so stamps keep growing when one engine
+        // takes over from another; call it before the first edit. getLastStamp is the latest stamp given out.
+        // Engines that hand out the caller's stamp ignore base and return 0.
+        virtual void set_stamp_base(std::uint64_t) {}
+
+        [[nodiscard]] virtual std::uint64_t getLastStamp() const {
+            return 0;
+        }
+
+        // Fills in what the engine knows about its last step: births, deaths, bounds, active tiles and memory
+        virtual void fill_stats(GenerationStats& stats) const = 0;
+
+    private:
+        mutable std::vector<glm::i64vec2> tile_cells_;
+    };
+
+    // Steps tiles across pool when the engine can; the pool must outlive the engine
+    std::unique_ptr<SimulationEngine> make_simulation_engine(SimulationEngineType type, ThreadPool* pool);
+}
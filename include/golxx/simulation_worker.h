@@ -0,0 +1,120 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "cell_region.h"
+#include "glm_common.h"
+#include "simulator.h"
+
+namespace golxx {
+    enum class SnapshotFormat {
+        // A list of the live cells
+        Cells,
+        // One byte per 2^block_shift square block of the region, shaded by how many of its cells live.
+        // The shift is the smallest that fits the region into MAX_BITMAP_SIZE, so 0 (one byte per cell,
+        // 255 when alive) unless the view is zoomed far out.
+        Bitmap,
+        // Whole 64x64 tiles overlapping the region, one bit per cell, each with the stamp of its last change
+        Tiles,
+    };
+
+    // Immutable view of the universe published by the simulation thread, limited to the view region
+    struct SimulationSnapshot {
+        static constexpr int MAX_BITMAP_SIZE = 2048;
+
+        std::uint64_t generation = 0;
+        CellRegion region;
+        SnapshotFormat format = SnapshotFormat::Cells;
+        // Live cells inside the region, whichever the format; only approximate for block shifts above 0,
+        // and for tiles it counts whole tiles
+        std::uint64_t population = 0;
+
+        std::vector<glm::i64vec2> cells;
+        // Row-major from the block holding region.min, so the first row is the bottom one
+        std::vector<std::uint8_t> bitmap;
+        unsigned int block_shift = 0;
+        std::vector<CellTile> tiles;
+
+        [[nodiscard]] static unsigned int bitmap_shift(const CellRegion& region);
+
+        [[nodiscard]] CellRegion bitmap_blocks() const {
+            return region.blocks(block_shift);
+        }
+
+        // Exact for cells, tiles and unshifted bitmaps, otherwise whether the cell's block has any live cell
+        [[nodiscard]] bool contains(glm::i64vec2 cell) const;
+    };
+
+    // Owns the thread that steps the simulator, so a slow generation never blocks input or rendering.
+    // Edits are queued and applied between generations; once started, the simulator must only
+    // be reached through the worker.
+    class SimulationWorker {
+    public:
+        // 0 generations per second steps as fast as the simulator allows
+        SimulationWorker(const std::shared_ptr<Simulator>& simulator, float generations_per_second);
+        ~SimulationWorker();
+
+        SimulationWorker(const SimulationWorker&) = delete;
+        SimulationWorker& operator=(const SimulationWorker&) = delete;
+
+        void set_running(bool running);
+        void request_step();
+        void set_state(glm::i64vec2 cell, bool state);
+
+        using Task = std::function<void(Simulator&)>;
+
+        // Runs task on the simulation thread after the pending edits, e.g. loading or saving a pattern.
+        // Exceptions it throws are reported and otherwise ignored.
+        void submit(Task task);
+
+        // Limits later snapshots to the cells inside region, published in the given format
+        void set_view(const CellRegion& region, SnapshotFormat format);
+
+        [[nodiscard]] std::shared_ptr<const SimulationSnapshot> getSnapshot();
+
+    private:
+        struct Edit {
+            glm::i64vec2 cell;
+            bool state;
+        };
+
+        using Clock = std::chrono::steady_clock;
+
+        void run();
+        void publish_snapshot();
+        std::shared_ptr<SimulationSnapshot> acquire_snapshot();
+
+    private:
+        std::shared_ptr<Simulator> simulator_;
+        Clock::duration step_interval_;
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::vector<Edit> pending_edits_;
+        std::vector<Edit> applied_edits_;
+        std::vector<Task> pending_tasks_;
+        std::vector<Task> applied_tasks_;
+        unsigned int pending_steps_ = 0;
+        bool running_ = false;
+        bool stopping_ = false;
+
+        // A snapshot is only built once the previous one has been picked up
+        std::shared_ptr<const SimulationSnapshot> snapshot_;
+        bool snapshot_requested_ = true;
+        bool snapshot_stale_ = false;
+        CellRegion view_region_;
+        SnapshotFormat view_format_ = SnapshotFormat::Cells;
+        // Only touched by the simulation thread. Snapshots nobody else holds anymore are refilled
+        // in place, keeping their buffers, instead of allocating a new one per generation.
+        std::vector<std::shared_ptr<SimulationSnapshot>> snapshot_pool_;
+        std::vector<glm::i64vec2> region_cells_;
+        std::vector<DensityBlock> region_blocks_;
+
+        std::thread thread_;
+    };
+}
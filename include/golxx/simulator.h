@@ -1,27 +1,136 @@
 #pragma once
-#include <unordered_set>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "cell_region.h"
+#include "engine_selector.h"
+#include "generation_stats.h"
 #include "glm_common.h"
+#include "life_rule.h"
+#include "simulation_engine.h"
+#include "thread_pool.h"
 
 namespace golxx {
+    // Runs a SimulationEngine and keeps what every engine shares: the rule, the generation count,
+    // the step size, the stamps of binned tiles and the statistics callback
     class Simulator {
     public:
-        Simulator() : generation_(0) {}
+        static constexpr unsigned int MAX_STEP_EXPONENT = SimulationEngine::MAX_STEP_EXPONENT;
+
+        // thread_count of 0 uses every hardware thread
+        explicit Simulator(SimulationEngineType engine = SimulationEngineType::BitTile,
+                           unsigned int thread_count = 0);
         ~Simulator() = default;
 
-        const std::unordered_set<glm::ivec2>& getCells() const {
-            return cells_;
+        // Appends the live cells inside region; cost follows the region rather than the population
+        // for the tile and HashLife engines
+        void collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const;
+
+        // Appends the population of the 2^shift x 2^shift blocks overlapping region; a block may appear
+        // more than once, in which case its populations add up. The tile and HashLife engines answer
+        // from population counts they keep anyway, so this stays cheap however far out the view is.
+        void collect_density(const CellRegion& region, unsigned int shift, std::vector<DensityBlock>& blocks) const;
+
+        // Appends the non-empty 64x64 tiles overlapping region. The tile engine stamps each tile with the
+        // step that last changed it; the others bin their cells and stamp every tile with the last change
+        // to the whole universe, so callers caching tiles by stamp only save work on the tile engine.
+        void collect_tiles(const CellRegion& region, std::vector<CellTile>& tiles) const;
+
+        std::uint64_t getPopulation() const {
+            return engine_->population();
         }
 
-        unsigned int getGeneration() const {
+        // Smallest region holding every live cell; empty when nothing lives
+        CellRegion bounds() const {
+            return engine_->bounds();
+        }
+
+        std::uint64_t getGeneration() const {
             return generation_;
         }
 
-        void set_state(glm::ivec2 cell, bool state);
+        SimulationEngineType getEngineType() const {
+            return engine_->getType();
+        }
+
+        // Moves the live cells over to a new engine of the given type; generation count and rule carry over
+        void set_engine(SimulationEngineType type);
+
+        // Lets the simulator migrate to whichever engine an EngineSelector expects to be fastest,
+        // logging every switch to std::clog
+        void set_auto_engine(bool enabled);
+
+        bool getAutoEngine() const {
+            return auto_engine_;
+        }
+
+        unsigned int getThreadCount() const {
+            return pool_->getThreadCount();
+        }
+
+        // Each run_cycle advances 2^exponent generations
+        unsigned int getStepExponent() const {
+            return step_exponent_;
+        }
+
+        void set_step_exponent(unsigned int exponent);
+
+        const LifeRule& getRule() const {
+            return rule_;
+        }
+
+        void set_rule(const LifeRule& rule);
+
+        // Cells must lie within CELL_LIMIT of the origin; std::invalid_argument otherwise
+        void set_state(glm::i64vec2 cell, bool state);
+
+        // Sets every cell live; pattern loaders use this to write straight into the engine's storage
+        void insert_cells(const std::vector<glm::i64vec2>& cells);
+
+        // Removes every cell and restarts the generation count
+        void clear();
 
         void run_cycle();
 
+        // Advances exactly the given number of generations regardless of the step exponent
+        void advance(std::uint64_t generations);
+
+        using StatsCallback = std::function<void(const GenerationStats&)>;
+
+        // Called on the stepping thread after every generation, or every jump on the HashLife engine.
+        // Gathering the numbers walks the whole universe, so leave it empty unless they are wanted.
+        void set_stats_callback(StatsCallback callback) {
+            stats_callback_ = std::move(callback);
+        }
+
+        bool hasStatsCallback() const {
+            return static_cast<bool>(stats_callback_);
+        }
+
     private:
-        std::unordered_set<glm::ivec2> cells_;
-        unsigned int generation_;
+        using Clock = std::chrono::steady_clock;
+
+        // Runs 2^step_exponent_ generations once the selector had its say
+        void cycle();
+        void select_engine(std::uint64_t generations_ahead);
+        void step(unsigned int exponent);
+        void publish_stats(std::uint64_t generations, Clock::time_point start);
+
+    private:
+        std::unique_ptr<ThreadPool> pool_;
+        std::unique_ptr<SimulationEngine> engine_;
+
+        // Bumped by every edit and cycle; stamps the tiles binned by engines without tiles of their own.
+        // Raised past the stamps of an engine that stamps its own tiles when that engine is replaced.
+        std::uint64_t version_ = 0;
+        std::uint64_t generation_ = 0;
+        unsigned int step_exponent_ = 0;
+        LifeRule rule_;
+        StatsCallback stats_callback_;
+        std::vector<glm::i64vec2> migrated_cells_;
+        bool auto_engine_ = false;
+        EngineSelector engine_selector_;
     };
 }
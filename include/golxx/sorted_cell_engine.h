@@ -0,0 +1,82 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "simulation_engine.h"
+#include "thread_pool.h"
+
+namespace golxx {
+    // The live cells as one list sorted by row, then column. A generation writes the nine cells around
+    // every live one as keys, radix sorts them and reads each cell's neighbor count off the length of its
+    // run, so memory is only ever streamed through. Keys are taken relative to the corner of each band of
+    // rows, so they stay 64-bit wherever the band lies. Large populations are cut into chunks of whole
+    // rows that step independently across the pool, each in buffers that are reused from then on.
+    class SortedCellEngine final : public SimulationEngine {
+    public:
+        // Live cells a chunk starts from; sizes its buffers to fit in cache
+        static constexpr std::size_t CHUNK_CELLS = std::size_t{1} << 12;
+
+        [[nodiscard]] SimulationEngineType getType() const override {
+            return SimulationEngineType::SortedCells;
+        }
+
+        // Steps chunks across pool when set; the pool must outlive the engine
+        void set_thread_pool(ThreadPool* pool) {
+            pool_ = pool;
+        }
+
+        void set_rule(const LifeRule& rule) override {
+            rule_ = rule;
+        }
+
+        void set_state(glm::i64vec2 cell, bool state) override;
+        void set_cells(const std::vector<glm::i64vec2>& cells) override;
+        void clear() override;
+
+        void step(unsigned int exponent) override;
+
+        [[nodiscard]] std::uint64_t population() const override {
+            return cells_.size();
+        }
+
+        [[nodiscard]] CellRegion bounds() const override;
+
+        void collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const override;
+        void collect_density(const CellRegion& region, unsigned int shift,
+                             std::vector<DensityBlock>& blocks) const override;
+
+        void fill_stats(GenerationStats& stats) const override;
+
+    private:
+        // Rows [first_row, end_row) of the next generation
+        struct Chunk {
+            std::int64_t first_row = 0;
+            std::int64_t end_row = 0;
+            std::vector<glm::i64vec2> cells;
+            std::uint64_t births = 0;
+            std::uint64_t deaths = 0;
+        };
+
+        // Sort buffers, one set per worker; cells is only used by bands too wide for 64-bit keys
+        struct Workspace {
+            std::vector<std::uint64_t> keys;
+            std::vector<std::uint64_t> scratch;
+            std::vector<glm::i64vec2> cells;
+        };
+
+        void step_generation();
+        using CellIterator = std::vector<glm::i64vec2>::const_iterator;
+
+        void step_chunk(Chunk& chunk, Workspace& workspace) const;
+        void step_band(Chunk& chunk, Workspace& workspace, CellIterator begin, CellIterator end) const;
+
+    private:
+        std::vector<glm::i64vec2> cells_;
+        std::vector<glm::i64vec2> next_cells_;
+        std::vector<Chunk> chunks_;
+        std::vector<Workspace> workspaces_;
+        std::uint64_t births_ = 0;
+        std::uint64_t deaths_ = 0;
+        LifeRule rule_;
+        ThreadPool* pool_ = nullptr;
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace golxx {
+    // Fork-join pool for data-parallel loops. Every thread owns a queue of index ranges,
+    // works through it from the back and steals from the front of the others once it runs dry.
+    class ThreadPool {
+    public:
+        using RangeFunction = std::function<void(std::size_t begin, std::size_t end)>;
+
+        // thread_count includes the calling thread; 0 uses every hardware thread
+        explicit ThreadPool(unsigned int thread_count = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        [[nodiscard]] unsigned int getThreadCount() const {
+            return static_cast<unsigned int>(queues_.size());
+        }
+
+        // Calls fn over [0, count) in chunks of at most grain indices and blocks until all are done
+        void parallel_for(std::size_t count, std::size_t grain, const RangeFunction& fn);
+
+    private:
+        struct Range {
+            std::size_t begin;
+            std::size_t end;
+        };
+
+        // Owner pops from the back, thieves take from front; both vectors keep their capacity between jobs
+        struct WorkQueue {
+            std::mutex mutex;
+            std::vector<Range> ranges;
+            std::size_t front = 0;
+        };
+
+        void worker_loop(unsigned int index);
+        bool run_one(unsigned int index);
+        bool pop_range(unsigned int index, Range& range);
+
+    private:
+        std::vector<std::unique_ptr<WorkQueue>> queues_;
+        std::vector<std::thread> threads_;
+
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+
+        const RangeFunction* job_ = nullptr;
+        std::atomic<std::size_t> remaining_{0};
+        std::uint64_t job_id_ = 0;
+        bool stopping_ = false;
+    };
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace golxx {
+    // Collects spans from every thread and writes them as Chrome trace-event JSON, which
+    // chrome://tracing and Perfetto open directly. While not recording a span costs one atomic load.
+    class TraceRecorder {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static TraceRecorder& get();
+
+        // Drops anything recorded before; the events go to filename on stop
+        void start(const std::string& filename);
+        // Writes the recorded events and stops; throws std::runtime_error when the file cannot be written
+        void stop();
+
+        [[nodiscard]] bool recording() const {
+            return recording_.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] const std::string& getFilename() const {
+            return filename_;
+        }
+
+        // Names the calling thread in later traces
+        void set_thread_name(const std::string& name);
+
+        // name, category and arg_name must outlive the recording; string literals do
+        void add_span(const char* name, const char* category, Clock::time_point start, Clock::time_point end,
+                      const char* arg_name = nullptr, std::int64_t arg = 0);
+
+    private:
+        struct Event {
+            const char* name;
+            const char* category;
+            Clock::time_point start;
+            Clock::time_point end;
+            std::uint32_t thread;
+            const char* arg_name;
+            std::int64_t arg;
+        };
+
+        TraceRecorder() = default;
+
+        static std::uint32_t thread_id();
+
+    private:
+        std::atomic<bool> recording_{false};
+        std::mutex mutex_;
+        std::vector<Event> events_;
+        std::vector<std::string> thread_names_;
+        std::string filename_;
+        Clock::time_point origin_;
+    };
+
+    // Records a span from construction to destruction when a trace is being recorded at construction
+    class TraceScope {
+    public:
+        TraceScope(const char* name, const char* category)
+            : name_(name),
+              category_(category),
+              active_(TraceRecorder::get().recording()) {
+            if (active_) {
+                start_ = TraceRecorder::Clock::now();
+            }
+        }
+
+        ~TraceScope() {
+            if (active_) {
+                TraceRecorder::get().add_span(name_, category_, start_, TraceRecorder::Clock::now(), arg_name_, arg_);
+            }
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+        // Shown with the span; arg_name must be a string literal
+        void set_arg(const char* arg_name, const std::int64_t value) {
+            arg_name_ = arg_name;
+            arg_ = value;
+        }
+
+    private:
+        const char* name_;
+        const char* category_;
+        bool active_;
+        TraceRecorder::Clock::time_point start_;
+        const char* arg_name_ = nullptr;
+        std::int64_t arg_ = 0;
+    };
+}
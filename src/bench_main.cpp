@@ -0,0 +1,391 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "golxx/life_kernels.h"
+#include "golxx/simulator.h"
+
+// Times every engine and thread count over a fixed corpus and writes the results as JSON.
+namespace {
+    using golxx::SimulationEngineType;
+
+    // place appends the pattern's live cells, which are loaded in one go
+    struct BenchPattern {
+        std::string name;
+        std::uint64_t generations;
+        std::function<void(std::vector<glm::i64vec2>&)> place;
+    };
+
+    struct BenchOptions {
+        std::vector<SimulationEngineType> engines{
+            SimulationEngineType::HashSet,
+            SimulationEngineType::BitTile,
+            SimulationEngineType::HashLife,
+            SimulationEngineType::SortedCells,
+        };
+        std::vector<unsigned int> threads;
+        std::vector<std::string> patterns;
+        std::vector<std::uint64_t> populations;
+        std::uint64_t generations = 0;
+        double max_seconds = 10.0;
+        std::string output = "-";
+    };
+
+    struct BenchResult {
+        std::string pattern;
+        SimulationEngineType engine;
+        unsigned int threads;
+        std::uint64_t generations;
+        double seconds;
+        std::uint64_t initial_population;
+        std::uint64_t final_population;
+        std::uint64_t cell_generations;
+    };
+
+    // Rows are listed top to bottom, 'O' is a live cell
+    void place_rows(std::vector<glm::i64vec2>& cells, const std::vector<const char*>& rows, const glm::i64vec2 origin) {
+        for (std::size_t y = 0; y < rows.size(); y++) {
+            for (std::size_t x = 0; rows[y][x] != '\0'; x++) {
+                if (rows[y][x] == 'O') {
+                    cells.push_back(origin + glm::i64vec2(x, -static_cast<std::int64_t>(y)));
+                }
+            }
+        }
+    }
+
+    const std::vector<const char*> GOSPER_GUN = {
+        "........................O...........",
+        "......................O.O...........",
+        "............OO......OO............OO",
+        "...........O...O....OO............OO",
+        "OO........O.....O...OO..............",
+        "OO........O...O.OO....O.O...........",
+        "..........O.....O.......O...........",
+        "...........O...O....................",
+        "............OO......................",
+    };
+
+    const std::vector<const char*> R_PENTOMINO = {
+        ".OO",
+        "OO.",
+        ".O.",
+    };
+
+    const std::vector<const char*> ACORN = {
+        ".O.....",
+        "...O...",
+        "OO..OOO",
+    };
+
+    // Same soup on every platform: the distributions in <random> are not portable, the engine is
+    BenchPattern random_soup(const int percent) {
+        return {"soup_" + std::to_string(percent), 200, [percent](std::vector<glm::i64vec2>& cells) {
+            constexpr int SIZE = 1024;
+            std::mt19937_64 random(0x601'1ffe);
+            for (int y = 0; y < SIZE; y++) {
+                for (int x = 0; x < SIZE; x++) {
+                    if (random() % 100 < static_cast<std::uint64_t>(percent)) {
+                        cells.push_back({x - SIZE / 2, y - SIZE / 2});
+                    }
+                }
+            }
+        }};
+    }
+
+    // 16x16 soups, one per 64x64 tile, laid out in a square until they hold population cells. The layout is
+    // the same at every size, so runs over a range of populations show how each engine's cost per cell
+    // scales once the universe outgrows the caches.
+    BenchPattern scattered_soups(const std::uint64_t population) {
+        return {"population_" + std::to_string(population), 100, [population](std::vector<glm::i64vec2>& cells) {
+            constexpr int SOUP_SIZE = 16;
+            constexpr int SPACING = 64;
+            // A soup is filled to 3/8, so holds about 96 cells
+            constexpr std::uint64_t SOUP_CELLS = SOUP_SIZE * SOUP_SIZE * 3 / 8;
+
+            const auto soups = (population + SOUP_CELLS - 1) / SOUP_CELLS;
+            const auto side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(soups))));
+            const auto target = cells.size() + population;
+            std::mt19937_64 random(0x601'1ffe);
+            for (int soup = 0; cells.size() < target; soup++) {
+                const glm::i64vec2 origin{(soup % side - side / 2) * SPACING, (soup / side - side / 2) * SPACING};
+                for (int y = 0; y < SOUP_SIZE && cells.size() < target; y++) {
+                    for (int x = 0; x < SOUP_SIZE && cells.size() < target; x++) {
+                        if (random() % 8 < 3) {
+                            cells.push_back(origin + glm::i64vec2(x, y));
+                        }
+                    }
+                }
+            }
+        }};
+    }
+
+    std::vector<BenchPattern> bench_corpus() {
+        return {
+            random_soup(10),
+            random_soup(25),
+            random_soup(50),
+            {"gosper_gun_field", 500, [](std::vector<glm::i64vec2>& cells) {
+                for (int y = 0; y < 8; y++) {
+                    for (int x = 0; x < 8; x++) {
+                        place_rows(cells, GOSPER_GUN, {x * 64, y * 64});
+                    }
+                }
+            }},
+            {"block_agar", 100, [](std::vector<glm::i64vec2>& cells) {
+                constexpr int SIZE = 2048;
+                for (int y = 0; y < SIZE; y += 3) {
+                    for (int x = 0; x < SIZE; x += 3) {
+                        place_rows(cells, {"OO", "OO"}, {x - SIZE / 2, y - SIZE / 2});
+                    }
+                }
+            }},
+            {"r_pentomino", 1103, [](std::vector<glm::i64vec2>& cells) {
+                place_rows(cells, R_PENTOMINO, {0, 0});
+            }},
+            {"acorn", 5206, [](std::vector<glm::i64vec2>& cells) {
+                place_rows(cells, ACORN, {0, 0});
+            }},
+        };
+    }
+
+    void print_usage(const char* program) {
+        std::cout << "Usage: " << program << " [options]\n"
+                  << "  --engines <list>      Comma separated engines (default: hashset,bittile,hashlife,sorted)\n"
+                  << "  --threads <list>      Thread counts for bittile and sorted (default: 1, 2, 4, ... up to all)\n"
+                  << "  --patterns <list>     Comma separated pattern names (default: all)\n"
+                  << "  --populations <list>  Run scattered soups of these populations instead, e.g. 1e3,1e5,1e7\n"
+                  << "  --generations <n>     Override the generations run per pattern\n"
+                  << "  --max-seconds <s>     Stop a run early once it took this long (default: 10)\n"
+                  << "  --output <file>       Write the JSON report, - for stdout (default: -)\n";
+    }
+
+    std::vector<std::string> split_list(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    std::uint64_t parse_count(const std::string& option, const std::string& value) {
+        try {
+            std::size_t end = 0;
+            const auto count = std::stoull(value, &end);
+            if (end == value.size() && value.front() != '-') {
+                return count;
+            }
+        } catch (const std::exception&) {}
+
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+
+    // Also takes scientific notation such as 1e6
+    std::uint64_t parse_population(const std::string& option, const std::string& value) {
+        try {
+            std::size_t end = 0;
+            const auto population = std::stod(value, &end);
+            if (end == value.size() && population >= 1.0 && population == std::floor(population)) {
+                return static_cast<std::uint64_t>(population);
+            }
+        } catch (const std::exception&) {}
+
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+
+    std::vector<unsigned int> default_thread_counts() {
+        const auto hardware = std::max(1u, std::thread::hardware_concurrency());
+
+        std::vector<unsigned int> counts;
+        for (unsigned int count = 1; count < hardware; count *= 2) {
+            counts.push_back(count);
+        }
+        counts.push_back(hardware);
+        return counts;
+    }
+
+    BenchOptions parse_arguments(const int argc, char** argv) {
+        BenchOptions options;
+
+        for (int i = 1; i < argc; i++) {
+            const std::string option = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + option);
+            }
+            const std::string value = argv[++i];
+
+            if (option == "--engines") {
+                options.engines.clear();
+                for (const auto& name : split_list(value)) {
+                    options.engines.push_back(golxx::parse_simulation_engine(name));
+                }
+            }
+            else if (option == "--threads") {
+                for (const auto& count : split_list(value)) {
+                    options.threads.push_back(static_cast<unsigned int>(parse_count(option, count)));
+                }
+            }
+            else if (option == "--patterns") {
+                options.patterns = split_list(value);
+            }
+            else if (option == "--populations") {
+                for (const auto& population : split_list(value)) {
+                    options.populations.push_back(parse_population(option, population));
+                }
+            }
+            else if (option == "--generations") {
+                options.generations = parse_count(option, value);
+            }
+            else if (option == "--max-seconds") {
+                options.max_seconds = std::stod(value);
+            }
+            else if (option == "--output") {
+                options.output = value;
+            }
+            else {
+                throw std::invalid_argument("Unknown option: " + option);
+            }
+        }
+
+        if (options.threads.empty()) {
+            options.threads = default_thread_counts();
+        }
+
+        return options;
+    }
+
+    BenchResult run_bench(const BenchPattern& pattern, const SimulationEngineType engine, const unsigned int threads,
+                          const BenchOptions& options) {
+        golxx::Simulator simulator(engine, threads);
+        {
+            std::vector<glm::i64vec2> cells;
+            pattern.place(cells);
+            simulator.insert_cells(cells);
+        }
+
+        BenchResult result{pattern.name, engine, simulator.getThreadCount(), 0, 0.0,
+                           simulator.getPopulation(), 0, 0};
+
+        const auto generations = options.generations ? options.generations : pattern.generations;
+        auto population = result.initial_population;
+
+        // Only the steps are timed; counting the population stays outside
+        while (result.generations < generations && result.seconds < options.max_seconds) {
+            const auto start = std::chrono::steady_clock::now();
+            simulator.run_cycle();
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+            result.seconds += elapsed.count();
+            result.generations++;
+            result.cell_generations += population;
+            population = simulator.getPopulation();
+        }
+
+        result.final_population = population;
+        return result;
+    }
+
+    void write_report(std::ostream& out, const std::vector<BenchResult>& results) {
+        out << "{\n"
+            << "  \"kernel\": \"" << golxx::get_life_kernel(golxx::LifeRule{}).name << "\",\n"
+            << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+            << "  \"results\": [";
+
+        for (std::size_t i = 0; i < results.size(); i++) {
+            const auto& result = results[i];
+            const auto per_second = [&](const double value) {
+                return result.seconds > 0.0 ? value / result.seconds : 0.0;
+            };
+
+            out << (i ? ",\n" : "\n")
+                << "    {\"pattern\": \"" << result.pattern << "\""
+                << ", \"engine\": \"" << golxx::to_string(result.engine) << "\""
+                << ", \"threads\": " << result.threads
+                << ", \"generations\": " << result.generations
+                << ", \"seconds\": " << result.seconds
+                << ", \"generations_per_second\": " << per_second(static_cast<double>(result.generations))
+                << ", \"cells_per_second\": " << per_second(static_cast<double>(result.cell_generations))
+                << ", \"initial_population\": " << result.initial_population
+                << ", \"final_population\": " << result.final_population << "}";
+        }
+
+        out << "\n  ]\n}\n";
+    }
+}
+
+int main(const int argc, char** argv) {
+    if (argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h")) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    try {
+        const auto options = parse_arguments(argc, argv);
+
+        std::vector<BenchPattern> corpus;
+        if (options.populations.empty()) {
+            corpus = bench_corpus();
+        }
+        else {
+            for (const auto population : options.populations) {
+                corpus.push_back(scattered_soups(population));
+            }
+        }
+
+        std::vector<BenchResult> results;
+        for (const auto& pattern : corpus) {
+            if (!options.patterns.empty() &&
+                std::find(options.patterns.begin(), options.patterns.end(), pattern.name) == options.patterns.end()) {
+                continue;
+            }
+
+            for (const auto engine : options.engines) {
+                // Only the tile and sorted engines step on the thread pool
+                const auto pooled = engine == SimulationEngineType::BitTile ||
+                    engine == SimulationEngineType::SortedCells;
+                const auto thread_counts = pooled ? options.threads : std::vector<unsigned int>{1};
+
+                for (const auto threads : thread_counts) {
+                    results.push_back(run_bench(pattern, engine, threads, options));
+
+                    const auto& result = results.back();
+                    std::clog << pattern.name << ' ' << golxx::to_string(engine) << " x" << result.threads << ": "
+                              << result.generations << " generations in " << result.seconds << "s\n";
+                }
+            }
+        }
+
+        if (options.output == "-") {
+            write_report(std::cout, results);
+        }
+        else {
+            std::ofstream report(options.output);
+            if (!report.is_open()) {
+                throw std::runtime_error("Failed to write report: " + options.output);
+            }
+            write_report(report, results);
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        print_usage(argv[0]);
+        return -1;
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,76 @@
+#include "golxx/allocation_tracker.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace golxx {
+    namespace {
+        std::atomic<std::uint64_t> allocation_counts[FRAME_PHASE_COUNT]{};
+        std::atomic<std::uint64_t> allocation_bytes[FRAME_PHASE_COUNT]{};
+        thread_local FramePhase current_phase = FramePhase::Other;
+    }
+
+    AllocationStats allocation_stats(const FramePhase phase) {
+        const auto index = static_cast<std::size_t>(phase);
+        return {
+            allocation_counts[index].load(std::memory_order_relaxed),
+            allocation_bytes[index].load(std::memory_order_relaxed),
+        };
+    }
+
+    AllocationStats allocation_stats() {
+        AllocationStats total;
+        for (std::size_t i = 0; i < FRAME_PHASE_COUNT; i++) {
+            const auto stats = allocation_stats(static_cast<FramePhase>(i));
+            total.count += stats.count;
+            total.bytes += stats.bytes;
+        }
+        return total;
+    }
+
+    AllocationScope::AllocationScope(const FramePhase phase)
+        : previous_(current_phase) {
+        current_phase = phase;
+    }
+
+    AllocationScope::~AllocationScope() {
+        current_phase = previous_;
+    }
+}
+
+#if defined(GOLXX_TRACK_ALLOCATIONS) || !defined(NDEBUG)
+namespace {
+    void record_allocation(const std::size_t size) {
+        const auto index = static_cast<std::size_t>(golxx::current_phase);
+        golxx::allocation_counts[index].fetch_add(1, std::memory_order_relaxed);
+        golxx::allocation_bytes[index].fetch_add(size, std::memory_order_relaxed);
+    }
+}
+
+// Array and sized forms forward to these by default; aligned forms are left alone and not counted
+void* operator new(const std::size_t size) {
+    record_allocation(size);
+    if (void* pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(const std::size_t size, const std::nothrow_t&) noexcept {
+    record_allocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+#endif
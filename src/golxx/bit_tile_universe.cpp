@@ -0,0 +1,636 @@
+#include "golxx/bit_tile_universe.h"
+
+#include <algorithm>
+#include "golxx/generation_stats.h"
+#include "golxx/trace_recorder.h"
+
+namespace golxx {
+    namespace {
+        constexpr int TILE_MASK = BitTileUniverse::TILE_SIZE - 1;
+        constexpr int PADDED_ROWS = BitTileUniverse::TILE_SIZE + 2;
+
+        int popcount(std::uint64_t value) {
+#if defined(__GNUC__)
+            return __builtin_popcountll(value);
+#else
+            int count = 0;
+            while (value) {
+                value &= value - 1;
+                count++;
+            }
+            return count;
+#endif
+        }
+
+        int count_trailing_zeros(const std::uint64_t value) {
+#if defined(__GNUC__)
+            return __builtin_ctzll(value);
+#else
+            int count = 0;
+            while (!(value >> count & 1)) {
+                count++;
+            }
+            return count;
+#endif
+        }
+
+        int count_leading_zeros(const std::uint64_t value) {
+#if defined(__GNUC__)
+            return __builtin_clzll(value);
+#else
+            int count = 0;
+            while (!(value >> (63 - count) & 1)) {
+                count++;
+            }
+            return count;
+#endif
+        }
+
+        glm::i64vec2 tile_of(const glm::i64vec2 cell) {
+            return {cell.x >> BitTileUniverse::TILE_SHIFT, cell.y >> BitTileUniverse::TILE_SHIFT};
+        }
+
+        glm::i64vec2 tile_origin(const glm::i64vec2 key) {
+            return {key.x * BitTileUniverse::TILE_SIZE, key.y * BitTileUniverse::TILE_SIZE};
+        }
+
+        // Bit i of a tile's border mask is set when it has live cells touching BORDER_NEIGHBORS[i]
+        // Opposite directions differ only in the lowest bit of their index
+        constexpr glm::i64vec2 BORDER_NEIGHBORS[8] = {
+            {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+            {-1, -1}, {1, 1}, {1, -1}, {-1, 1},
+        };
+
+        std::uint8_t border_mask(const BitTileUniverse::TileRows& rows, const std::uint64_t columns) {
+            constexpr auto first_bit = std::uint64_t{1};
+            constexpr auto last_bit = std::uint64_t{1} << TILE_MASK;
+
+            const auto bottom = rows.front();
+            const auto top = rows.back();
+
+            return static_cast<std::uint8_t>(
+                (columns & first_bit ? 1 : 0) |
+                (columns & last_bit ? 2 : 0) |
+                (bottom ? 4 : 0) |
+                (top ? 8 : 0) |
+                (bottom & first_bit ? 16 : 0) |
+                (top & last_bit ? 32 : 0) |
+                (bottom & last_bit ? 64 : 0) |
+                (top & first_bit ? 128 : 0));
+        }
+
+        constexpr glm::i64vec2 NEIGHBORHOOD[9] = {
+            {0, 0},
+            {-1, 0}, {1, 0}, {0, -1}, {0, 1},
+            {-1, -1}, {1, 1}, {1, -1}, {-1, 1},
+        };
+
+        // Tiles handed to a worker at a time
+        constexpr std::size_t STEP_GRAIN = 16;
+    }
+
+    BitTileUniverse::BitTileUniverse()
+        : step_rows_(get_life_kernel(rule_).step_rows) {}
+
+    void BitTileUniverse::set_rule(const LifeRule& rule) {
+        rule_ = rule;
+        step_rows_ = get_life_kernel(rule_).step_rows;
+
+        // History gathered under the old rule predicts nothing
+        for (auto& [key, tile] : tiles_) {
+            mark_edited(key, tile);
+        }
+    }
+
+    void BitTileUniverse::set_state(const glm::i64vec2 cell, const bool state) {
+        const auto key = tile_of(cell);
+        const auto bit = std::uint64_t{1} << (cell.x & TILE_MASK);
+        const auto row = cell.y & TILE_MASK;
+
+        version_++;
+        if (state) {
+            auto& tile = tile_nodes_.emplace(tiles_, key).first->second;
+            const auto population = tile.population[current_];
+            tile.rows[current_][row] |= bit;
+            tile.stamps[current_] = version_;
+            update_summary(tile, current_);
+            mark_edited(key, tile);
+            add_population_delta(key, tile.population[current_] - population);
+        }
+        else if (const auto it = tiles_.find(key); it != tiles_.end()) {
+            const auto population = it->second.population[current_];
+            it->second.rows[current_][row] &= ~bit;
+            it->second.stamps[current_] = version_;
+            update_summary(it->second, current_);
+            mark_edited(key, it->second);
+            add_population_delta(key, it->second.population[current_] - population);
+        }
+        update_pyramid(current_);
+    }
+
+    void BitTileUniverse::set_cells(const std::vector<glm::i64vec2>& cells) {
+        edited_tiles_.clear();
+        version_++;
+
+        // Cells mostly arrive row by row, so consecutive ones usually share a tile
+        glm::i64vec2 key{};
+        Tile* tile = nullptr;
+        for (const auto cell : cells) {
+            const auto cell_key = tile_of(cell);
+            if (!tile || cell_key != key) {
+                key = cell_key;
+                tile = &tile_nodes_.emplace(tiles_, key).first->second;
+                edited_tiles_.push_back({key, tile, 0, 0});
+            }
+
+            tile->rows[current_][cell.y & TILE_MASK] |= std::uint64_t{1} << (cell.x & TILE_MASK);
+        }
+
+        std::sort(edited_tiles_.begin(), edited_tiles_.end(), [](const VisitedTile& a, const VisitedTile& b) {
+            return std::less<const Tile*>()(a.tile, b.tile);
+        });
+        const auto last = std::unique(edited_tiles_.begin(), edited_tiles_.end(), [](const VisitedTile& a, const VisitedTile& b) {
+            return a.tile == b.tile;
+        });
+
+        for (auto it = edited_tiles_.begin(); it != last; ++it) {
+            const auto population = it->tile->population[current_];
+            it->tile->stamps[current_] = version_;
+            update_summary(*it->tile, current_);
+            mark_edited(it->key, *it->tile);
+            add_population_delta(it->key, it->tile->population[current_] - population);
+        }
+        update_pyramid(current_);
+    }
+
+    bool BitTileUniverse::get_state(const glm::i64vec2 cell) const {
+        const auto* tile = find_tile(tile_of(cell));
+        if (!tile) {
+            return false;
+        }
+
+        return tile->rows[current_][cell.y & TILE_MASK] >> (cell.x & TILE_MASK) & 1;
+    }
+
+    void BitTileUniverse::step(const unsigned int exponent) {
+        for (std::uint64_t i = 0; i < std::uint64_t{1} << exponent; i++) {
+            step_generation();
+        }
+    }
+
+    void BitTileUniverse::step_generation() {
+        step_count_++;
+        version_++;
+        expand_border_tiles();
+        collect_visits();
+
+        // Every tile only writes its own next buffer, so the result does not depend on scheduling
+        const auto step_range = [this](const std::size_t begin, const std::size_t end) {
+            TraceScope trace("tile_batch", "sim");
+            trace.set_arg("tiles", static_cast<std::int64_t>(end - begin));
+            for (auto i = begin; i < end; i++) {
+                auto& visit = visit_order_[i];
+                const auto population = visit.tile->population[current_ ^ 1];
+                visit.activity = step_tile(visit.key, *visit.tile);
+                visit.population_delta = visit.tile->population[current_ ^ 1] - population;
+            }
+        };
+
+        if (pool_) {
+            pool_->parallel_for(visit_order_.size(), STEP_GRAIN, step_range);
+        }
+        else {
+            step_range(0, visit_order_.size());
+        }
+
+        current_ ^= 1;
+        apply_visits();
+    }
+
+    void BitTileUniverse::clear() {
+        tiles_.clear();
+        hot_tiles_.clear();
+        visit_order_.clear();
+        edited_tiles_.clear();
+        for (auto& level : pyramid_) {
+            level.clear();
+        }
+        current_ = 0;
+    }
+
+    BitTileUniverse::CellChanges BitTileUniverse::last_changes() const {
+        // Both buffers hold a generation, the present one and the one before, whether the tile was stepped or not
+        CellChanges changes;
+        for (const auto& [key, tile] : tiles_) {
+            if (!(tile.activity & CHANGED)) {
+                continue;
+            }
+
+            const auto& rows = tile.rows[current_];
+            const auto& previous = tile.rows[current_ ^ 1];
+            for (int y = 0; y < TILE_SIZE; y++) {
+                changes.births += popcount(rows[y] & ~previous[y]);
+                changes.deaths += popcount(previous[y] & ~rows[y]);
+            }
+        }
+        return changes;
+    }
+
+    CellRegion BitTileUniverse::bounds() const {
+        CellRegion bounds;
+        for (const auto& [key, tile] : tiles_) {
+            if (!tile.population[current_]) {
+                continue;
+            }
+
+            const auto& rows = tile.rows[current_];
+            std::uint64_t columns = 0;
+            int min_y = TILE_SIZE;
+            int max_y = -1;
+            for (int y = 0; y < TILE_SIZE; y++) {
+                if (rows[y]) {
+                    columns |= rows[y];
+                    min_y = std::min(min_y, y);
+                    max_y = y;
+                }
+            }
+
+            const auto origin = tile_origin(key);
+            const CellRegion tile_bounds{
+                origin + glm::i64vec2(count_trailing_zeros(columns), min_y),
+                origin + glm::i64vec2(TILE_MASK - count_leading_zeros(columns), max_y)
+            };
+            if (bounds.empty()) {
+                bounds = tile_bounds;
+            }
+            else {
+                bounds.min = glm::min(bounds.min, tile_bounds.min);
+                bounds.max = glm::max(bounds.max, tile_bounds.max);
+            }
+        }
+        return bounds;
+    }
+
+    void BitTileUniverse::fill_stats(GenerationStats& stats) const {
+        const auto changes = last_changes();
+        stats.births = changes.births;
+        stats.deaths = changes.deaths;
+        stats.bounds = bounds();
+        stats.active_tiles = getActiveTileCount();
+        stats.memory_bytes = memory_usage();
+    }
+
+    std::size_t BitTileUniverse::memory_usage() const {
+        auto bytes = hash_container_memory(tiles_);
+        for (const auto& level : pyramid_) {
+            bytes += hash_container_memory(level);
+        }
+        bytes += (hot_tiles_.capacity() + next_hot_tiles_.capacity() + erase_candidates_.capacity()) *
+            sizeof(glm::i64vec2);
+        bytes += (visit_order_.capacity() + edited_tiles_.capacity()) * sizeof(VisitedTile);
+        bytes += population_deltas_.capacity() * sizeof(PopulationDelta);
+        return bytes;
+    }
+
+    std::uint64_t BitTileUniverse::population() const {
+        std::uint64_t count = 0;
+        for (const auto& [key, tile] : tiles_) {
+            count += tile.population[current_];
+        }
+        return count;
+    }
+
+    template <typename Fn>
+    void BitTileUniverse::for_each_tile(const CellRegion& region, const Fn& fn) const {
+        const auto tile_region = region.blocks(TILE_SHIFT);
+
+        // Look the region's tiles up when there are fewer of them than stored tiles, else filter the stored ones
+        if (tile_region.area() <= tiles_.size()) {
+            for (auto y = tile_region.min.y; y <= tile_region.max.y; y++) {
+                for (auto x = tile_region.min.x; x <= tile_region.max.x; x++) {
+                    if (const auto* tile = find_tile({x, y}); tile && tile->population[current_]) {
+                        fn({x, y}, *tile);
+                    }
+                }
+            }
+        }
+        else {
+            for (const auto& [key, tile] : tiles_) {
+                if (tile_region.contains(key) && tile.population[current_]) {
+                    fn(key, tile);
+                }
+            }
+        }
+    }
+
+    void BitTileUniverse::collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const {
+        if (region.empty()) {
+            return;
+        }
+
+        for_each_tile(region, [&](const glm::i64vec2 key, const Tile& tile) {
+            const auto origin = tile_origin(key);
+            const auto min = glm::max(region.min - origin, glm::i64vec2(0));
+            const auto max = glm::min(region.max - origin, glm::i64vec2(TILE_MASK));
+            const auto columns = (~std::uint64_t{0} << min.x) & (~std::uint64_t{0} >> (TILE_MASK - max.x));
+
+            for (auto y = min.y; y <= max.y; y++) {
+                auto row = tile.rows[current_][y] & columns;
+                while (row) {
+                    cells.push_back(origin + glm::i64vec2(count_trailing_zeros(row), y));
+                    row &= row - 1;
+                }
+            }
+        });
+    }
+
+    void BitTileUniverse::collect_density(const CellRegion& region, const unsigned int shift,
+                                          std::vector<DensityBlock>& blocks) const {
+        if (region.empty()) {
+            return;
+        }
+
+        // Blocks smaller than a tile are counted from its rows
+        if (shift < static_cast<unsigned int>(TILE_SHIFT)) {
+            const auto block_size = 1 << shift;
+            const auto block_mask = (std::uint64_t{1} << block_size) - 1;
+
+            for_each_tile(region, [&](const glm::i64vec2 key, const Tile& tile) {
+                const auto origin = tile_origin(key);
+                for (int y = 0; y < TILE_SIZE; y += block_size) {
+                    for (int x = 0; x < TILE_SIZE; x += block_size) {
+                        int population = 0;
+                        for (int row = y; row < y + block_size; row++) {
+                            population += popcount(tile.rows[current_][row] >> x & block_mask);
+                        }
+
+                        const auto cell = origin + glm::i64vec2(x, y);
+                        if (population && region.intersects({cell, cell + glm::i64vec2(block_size - 1)})) {
+                            blocks.push_back({{cell.x >> shift, cell.y >> shift}, static_cast<std::uint64_t>(population)});
+                        }
+                    }
+                }
+            });
+            return;
+        }
+
+        if (shift == static_cast<unsigned int>(TILE_SHIFT)) {
+            for_each_tile(region, [&](const glm::i64vec2 key, const Tile& tile) {
+                blocks.push_back({key, tile.population[current_]});
+            });
+            return;
+        }
+
+        // Pyramid levels are capped; beyond them several entries fall into one block and add up
+        const auto level = std::min<unsigned int>(shift - TILE_SHIFT, PYRAMID_LEVELS) - 1;
+        const auto level_shift = static_cast<unsigned int>(TILE_SHIFT) + level + 1;
+        const auto level_region = region.blocks(level_shift);
+        const auto& entries = pyramid_[level];
+
+        const auto emit = [&](const glm::i64vec2 key, const std::uint64_t population) {
+            if (population) {
+                const auto extra = shift - level_shift;
+                blocks.push_back({{key.x >> extra, key.y >> extra}, population});
+            }
+        };
+
+        if (level_region.area() <= entries.size()) {
+            for (auto y = level_region.min.y; y <= level_region.max.y; y++) {
+                for (auto x = level_region.min.x; x <= level_region.max.x; x++) {
+                    if (const auto it = entries.find({x, y}); it != entries.end()) {
+                        emit(it->first, it->second[current_]);
+                    }
+                }
+            }
+        }
+        else {
+            for (const auto& [key, populations] : entries) {
+                if (level_region.contains(key)) {
+                    emit(key, populations[current_]);
+                }
+            }
+        }
+    }
+
+    void BitTileUniverse::visit_tiles(const CellRegion& region, std::uint64_t, const TileVisitor& visit) const {
+        if (region.empty()) {
+            return;
+        }
+
+        for_each_tile(region, [&](const glm::i64vec2 key, const Tile& tile) {
+            visit(key, tile.stamps[current_], tile.rows[current_]);
+        });
+    }
+
+    const BitTileUniverse::Tile* BitTileUniverse::find_tile(const glm::i64vec2 tile) const {
+        const auto it = tiles_.find(tile);
+        return it != tiles_.end() ? &it->second : nullptr;
+    }
+
+    void BitTileUniverse::update_summary(Tile& tile, const int buffer) {
+        const auto& rows = tile.rows[buffer];
+
+        int population = 0;
+        std::uint64_t columns = 0;
+        for (const auto row : rows) {
+            population += popcount(row);
+            columns |= row;
+        }
+
+        tile.population[buffer] = static_cast<std::uint16_t>(population);
+        tile.borders[buffer] = border_mask(rows, columns);
+    }
+
+    void BitTileUniverse::mark_edited(const glm::i64vec2 key, Tile& tile) {
+        if (tile.activity & PERIOD2) {
+            hot_tiles_.push_back(key);
+        }
+        tile.activity = CHANGED | EDITED;
+    }
+
+    void BitTileUniverse::expand_border_tiles() {
+        // Cells on a tile border can give birth in the neighboring tile, so it must exist before stepping.
+        // Borders of quiet tiles are left alone: a quiet neighborhood cannot give birth.
+        for (std::size_t i = 0, count = hot_tiles_.size(); i < count; i++) {
+            const auto key = hot_tiles_[i];
+            const auto it = tiles_.find(key);
+            if (it == tiles_.end()) {
+                continue;
+            }
+
+            const auto borders = it->second.borders[current_];
+            for (int bit = 0; bit < 8; bit++) {
+                if (borders >> bit & 1) {
+                    // A missing tile has been empty for at least two generations, so it starts out quiet
+                    tile_nodes_.emplace(tiles_, key + BORDER_NEIGHBORS[bit]);
+                }
+            }
+        }
+    }
+
+    void BitTileUniverse::collect_visits() {
+        visit_order_.clear();
+
+        for (const auto key : hot_tiles_) {
+            for (const auto offset : NEIGHBORHOOD) {
+                const auto it = tiles_.find(key + offset);
+                if (it == tiles_.end() || it->second.visit_stamp == step_count_) {
+                    continue;
+                }
+
+                it->second.visit_stamp = step_count_;
+                visit_order_.push_back({it->first, &it->second, 0, 0});
+            }
+        }
+    }
+
+    std::uint8_t BitTileUniverse::step_tile(const glm::i64vec2 key, Tile& tile) const {
+        static constexpr TileRows empty_rows{};
+
+        const Tile* neighbors[8];
+        auto any_activity = tile.activity;
+        auto all_activity = tile.activity;
+        for (int i = 0; i < 8; i++) {
+            neighbors[i] = find_tile(key + BORDER_NEIGHBORS[i]);
+            const auto activity = neighbors[i] ? neighbors[i]->activity : static_cast<std::uint8_t>(PERIOD2);
+            any_activity |= activity;
+            all_activity &= activity;
+        }
+
+        const auto next = current_ ^ 1;
+
+        // The next buffer still holds the previous generation, which is the answer in both quiet cases
+        if (!(any_activity & CHANGED)) {
+            return PERIOD2;
+        }
+        if (all_activity & PERIOD2) {
+            return tile.activity;
+        }
+
+        const auto rows_of = [&](const int neighbor) -> const TileRows& {
+            return neighbors[neighbor] ? neighbors[neighbor]->rows[current_] : empty_rows;
+        };
+
+        const auto& rows = tile.rows[current_];
+        const auto& west = rows_of(0);
+        const auto& east = rows_of(1);
+        const auto& below = rows_of(2);
+        const auto& above = rows_of(3);
+
+        std::uint64_t left[PADDED_ROWS];
+        std::uint64_t center[PADDED_ROWS];
+        std::uint64_t right[PADDED_ROWS];
+
+        const auto pad_row = [&](const int index, const std::uint64_t c, const std::uint64_t w, const std::uint64_t e) {
+            center[index] = c;
+            left[index] = c << 1 | w >> TILE_MASK;
+            right[index] = c >> 1 | e << TILE_MASK;
+        };
+
+        pad_row(0, below.back(), rows_of(4).back(), rows_of(6).back());
+        for (int y = 0; y < TILE_SIZE; y++) {
+            pad_row(y + 1, rows[y], west[y], east[y]);
+        }
+        pad_row(PADDED_ROWS - 1, above.front(), rows_of(7).front(), rows_of(5).front());
+
+        TileRows result;
+        step_rows_(left, center, right, result.data(), rule_.birth, rule_.survival);
+
+        std::uint8_t activity = 0;
+        if (result != rows) {
+            activity |= CHANGED;
+        }
+        if (!(tile.activity & EDITED) && result == tile.rows[next]) {
+            activity |= PERIOD2;
+        }
+
+        // Same contents, same stamp: a still life keeps one stamp across both buffers
+        if (result == rows) {
+            tile.stamps[next] = tile.stamps[current_];
+        }
+        else if (result != tile.rows[next]) {
+            tile.stamps[next] = version_;
+        }
+
+        tile.rows[next] = result;
+        update_summary(tile, next);
+        return activity;
+    }
+
+    void BitTileUniverse::apply_visits() {
+        next_hot_tiles_.clear();
+        erase_candidates_.clear();
+
+        for (const auto& visit : visit_order_) {
+            auto& tile = *visit.tile;
+            tile.activity = visit.activity;
+            add_population_delta(visit.key, visit.population_delta);
+
+            if (!(tile.activity & PERIOD2)) {
+                next_hot_tiles_.push_back(visit.key);
+            }
+            else if (!(tile.activity & CHANGED) && tile.population[current_] == 0 && tile.population[current_ ^ 1] == 0) {
+                erase_candidates_.push_back(visit.key);
+            }
+        }
+
+        std::swap(hot_tiles_, next_hot_tiles_);
+        update_pyramid(current_);
+
+        // Empty for three generations; keep it anyway while a neighbor's border cells would recreate it
+        for (const auto key : erase_candidates_) {
+            if (!is_border_target(key)) {
+                tile_nodes_.erase(tiles_, key);
+            }
+        }
+    }
+
+    void BitTileUniverse::add_population_delta(const glm::i64vec2 key, const std::int64_t delta) {
+        if (delta) {
+            population_deltas_.push_back({key, delta});
+        }
+    }
+
+    void BitTileUniverse::update_pyramid(const int buffer) {
+        // Each level halves the keys of the one below; neighbors usually follow each other in the
+        // visit order, so merging runs of equal keys first saves most of the map updates
+        for (auto& level : pyramid_) {
+            std::size_t merged = 0;
+            for (const auto& [key, delta] : population_deltas_) {
+                const glm::i64vec2 parent(key.x >> 1, key.y >> 1);
+                if (merged > 0 && population_deltas_[merged - 1].key == parent) {
+                    population_deltas_[merged - 1].delta += delta;
+                }
+                else {
+                    population_deltas_[merged++] = {parent, delta};
+                }
+            }
+            population_deltas_.resize(merged);
+
+            for (const auto& [key, delta] : population_deltas_) {
+                if (!delta) {
+                    continue;
+                }
+
+                auto& populations = pyramid_nodes_.emplace(level, key).first->second;
+                populations[buffer] += delta;
+                if (populations[0] == 0 && populations[1] == 0) {
+                    pyramid_nodes_.erase(level, key);
+                }
+            }
+        }
+
+        population_deltas_.clear();
+    }
+
+    bool BitTileUniverse::is_border_target(const glm::i64vec2 key) const {
+        for (int bit = 0; bit < 8; bit++) {
+            // The neighbor at BORDER_NEIGHBORS[bit] points back at this tile with the opposite bit
+            const auto* neighbor = find_tile(key + BORDER_NEIGHBORS[bit]);
+            if (neighbor && neighbor->borders[current_] >> (bit ^ 1) & 1) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,103 @@
+#include "golxx/cell_hash_set.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace golxx {
+    bool CellHashSet::insert(const glm::i64vec2 cell) {
+        if (contains(cell)) {
+            return false;
+        }
+
+        if ((size_ + 1) * MAX_LOAD_DENOMINATOR > slots_.size() * MAX_LOAD_NUMERATOR) {
+            rehash(std::max(MIN_CAPACITY, slots_.size() * 2));
+        }
+
+        place(cell);
+        size_++;
+        return true;
+    }
+
+    bool CellHashSet::erase(const glm::i64vec2 cell) {
+        if (size_ == 0) {
+            return false;
+        }
+
+        auto index = home(cell);
+        for (std::uint32_t distance = 1;; distance++) {
+            const auto& slot = slots_[index];
+            if (slot.distance < distance) {
+                return false;
+            }
+            if (slot.distance == distance && slot.cell == cell) {
+                break;
+            }
+            index = (index + 1) & mask_;
+        }
+
+        // Pull the rest of the run one slot closer to home until a resident already sits there
+        auto next = (index + 1) & mask_;
+        while (slots_[next].distance > 1) {
+            slots_[index] = slots_[next];
+            slots_[index].distance--;
+            index = next;
+            next = (next + 1) & mask_;
+        }
+        slots_[index].distance = 0;
+
+        size_--;
+        return true;
+    }
+
+    void CellHashSet::reserve(const std::size_t count) {
+        auto capacity = std::max(MIN_CAPACITY, slots_.size());
+        while (count * MAX_LOAD_DENOMINATOR > capacity * MAX_LOAD_NUMERATOR) {
+            capacity *= 2;
+        }
+        if (capacity != slots_.size()) {
+            rehash(capacity);
+        }
+    }
+
+    void CellHashSet::clear() {
+        for (auto& slot : slots_) {
+            slot.distance = 0;
+        }
+        size_ = 0;
+    }
+
+    void CellHashSet::rehash(const std::size_t capacity) {
+        // The previous table is kept around for the next rehash rather than freed
+        std::swap(slots_, old_slots_);
+        slots_.assign(capacity, Slot{{}, 0});
+        mask_ = capacity - 1;
+
+        for (const auto& slot : old_slots_) {
+            if (slot.distance != 0) {
+                place(slot.cell);
+            }
+        }
+        old_slots_.clear();
+    }
+
+    void CellHashSet::place(glm::i64vec2 cell) {
+        auto index = home(cell);
+        std::uint32_t distance = 1;
+        while (true) {
+            auto& slot = slots_[index];
+            if (slot.distance == 0) {
+                slot = {cell, distance};
+                return;
+            }
+
+            // Robin Hood: the cell further from home takes the slot and the resident moves on
+            if (slot.distance < distance) {
+                std::swap(slot.cell, cell);
+                std::swap(slot.distance, distance);
+            }
+
+            index = (index + 1) & mask_;
+            distance++;
+        }
+    }
+}
@@ -117,9 +117,26 @@ namespace golxx {
                 }
             };
 
+            // Parse simple string values
+            auto parseString = [&](const std::string& key, std::string& value) {
+                if (auto pos = jsonContent.find("\"" + key + "\""); pos != std::string::npos) {
+                    auto colonPos = jsonContent.find(':', pos);
+                    auto start = jsonContent.find('"', colonPos);
+                    auto end = jsonContent.find('"', start + 1);
+
+                    if (colonPos != std::string::npos && start != std::string::npos && end != std::string::npos) {
+                        value = jsonContent.substr(start + 1, end - start - 1);
+                    }
+                }
+            };
+
             // Parse configuration values
             parseFloat("initialZoom", config_.initialZoom);
             parseFloat("playerSpeed", config_.playerSpeed);
+            parseInt("simulationThreads", config_.simulationThreads);
+            parseFloat("generationsPerSecond", config_.generationsPerSecond);
+            parseString("rule", config_.rule);
+            parseString("engine", config_.engine);
 
             return true;
         } catch (const std::exception& e) {
@@ -141,6 +158,12 @@ namespace golxx {
         json << "  },\n";
         json << "  \"player\": {\n";
         json << "    \"playerSpeed\": " << config_.playerSpeed << "\n";
+        json << "  },\n";
+        json << "  \"simulation\": {\n";
+        json << "    \"simulationThreads\": " << config_.simulationThreads << ",\n";
+        json << "    \"generationsPerSecond\": " << config_.generationsPerSecond << ",\n";
+        json << "    \"rule\": \"" << config_.rule << "\",\n";
+        json << "    \"engine\": \"" << config_.engine << "\"\n";
         json << "  }\n";
         json << "}\n";
         return json.str();
@@ -0,0 +1,121 @@
+#include "golxx/engine_selector.h"
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <vector>
+
+namespace golxx {
+    namespace {
+        // HashLife needs this many generations ahead before a jump beats stepping one by one
+        constexpr std::uint64_t HASHLIFE_MIN_GENERATIONS = 64;
+        // Stepping one by one cannot cover this many generations in reasonable time, so a small universe
+        // goes to HashLife even when nothing repeats yet: its jumps still skip the bulk of the run
+        constexpr std::uint64_t HASHLIFE_FAR_GENERATIONS = std::uint64_t{1} << 20;
+        constexpr std::uint64_t HASHLIFE_FAR_POPULATION = std::uint64_t{1} << 16;
+        // Share of tiles that are copies of another one
+        constexpr double HASHLIFE_REPETITION = 0.6;
+        constexpr double GROWING_REPETITION = 0.3;
+        // Bounding box area over the one a sample earlier
+        constexpr double GROWTH = 1.5;
+        // Fewer tiles than this say nothing about repetition
+        constexpr std::size_t MIN_REPETITION_TILES = 16;
+
+        // The sorted engine steps a live cell in about a quarter of the time the tile engine steps a whole
+        // tile, whatever the population, so it pays off below this many live cells per occupied tile
+        constexpr double SPARSE_CELLS_PER_TILE = 4.0;
+
+        std::uint64_t hash_rows(const std::array<std::uint64_t, CellTile::SIZE>& rows) {
+            std::uint64_t hash = 0xcbf29ce484222325ULL;
+            for (const auto row : rows) {
+                hash = (hash ^ row) * 0x100000001b3ULL;
+                hash ^= hash >> 29;
+            }
+            return hash;
+        }
+
+        // Share of the tiles whose hash is a copy of another one's; sorts hashes
+        double tile_repetition(std::vector<std::uint64_t>& hashes) {
+            if (hashes.size() < MIN_REPETITION_TILES) {
+                return 0.0;
+            }
+
+            std::sort(hashes.begin(), hashes.end());
+            const auto distinct = std::unique(hashes.begin(), hashes.end()) - hashes.begin();
+            return 1.0 - static_cast<double>(distinct) / static_cast<double>(hashes.size());
+        }
+    }
+
+    std::optional<SimulationEngineType> EngineSelector::sample(const SimulationEngine& engine,
+                                                               const std::uint64_t generation,
+                                                               const std::uint64_t generations_ahead) {
+        if (generation < next_sample_) {
+            return std::nullopt;
+        }
+        next_sample_ = generation + SAMPLE_INTERVAL;
+
+        const auto population = engine.population();
+        const auto bounds = engine.bounds();
+        const auto area = bounds.area();
+        const auto growth = previous_area_ ? static_cast<double>(area) / static_cast<double>(previous_area_) : 1.0;
+        previous_area_ = area;
+
+        // An empty universe runs equally fast anywhere, and a huge one costs too much to bin or to migrate
+        if (population == 0 || population > MAX_SAMPLED_POPULATION) {
+            candidate_.reset();
+            confirmations_ = 0;
+            return std::nullopt;
+        }
+
+        // Hashing the tiles where they lie keeps a sample at eight bytes per tile; the hashes go once it is done
+        std::vector<std::uint64_t> tile_hashes;
+        engine.visit_tiles(bounds, 0, [&](glm::i64vec2, std::uint64_t,
+                                          const std::array<std::uint64_t, CellTile::SIZE>& rows) {
+            tile_hashes.push_back(hash_rows(rows));
+        });
+        const auto tile_count = tile_hashes.size();
+        const auto cells_per_tile = static_cast<double>(population) / static_cast<double>(tile_count);
+        const auto repetition = tile_repetition(tile_hashes);
+
+        auto proposal = SimulationEngineType::BitTile;
+        const bool repeats =
+            repetition >= HASHLIFE_REPETITION || (repetition >= GROWING_REPETITION && growth >= GROWTH);
+        const bool far_ahead = generations_ahead >= HASHLIFE_FAR_GENERATIONS && population <= HASHLIFE_FAR_POPULATION;
+        if (far_ahead || (generations_ahead >= HASHLIFE_MIN_GENERATIONS && repeats)) {
+            proposal = SimulationEngineType::HashLife;
+        }
+        else if (cells_per_tile < SPARSE_CELLS_PER_TILE) {
+            proposal = SimulationEngineType::SortedCells;
+        }
+
+        if (proposal == engine.getType()) {
+            candidate_.reset();
+            confirmations_ = 0;
+            return std::nullopt;
+        }
+        if (candidate_ != proposal) {
+            candidate_ = proposal;
+            confirmations_ = 0;
+        }
+        if (++confirmations_ < CONFIRMATIONS) {
+            return std::nullopt;
+        }
+
+        std::ostringstream reason;
+        reason << population << " cells in " << tile_count << " tiles, "
+               << repetition * 100.0 << "% of the tiles repeat, bounding box grew " << growth << "x, "
+               << generations_ahead << " generations ahead";
+        reason_ = reason.str();
+
+        candidate_.reset();
+        confirmations_ = 0;
+        return proposal;
+    }
+
+    void EngineSelector::reset() {
+        next_sample_ = 0;
+        previous_area_ = 0;
+        candidate_.reset();
+        confirmations_ = 0;
+    }
+}
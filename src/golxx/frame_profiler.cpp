@@ -0,0 +1,189 @@
+#include "golxx/frame_profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace golxx {
+    namespace {
+        constexpr double MILLISECONDS = 1000.0;
+    }
+
+    const char* to_string(const FramePhase phase) {
+        switch (phase) {
+        case FramePhase::Other:
+            return "other";
+        case FramePhase::Poll:
+            return "poll";
+        case FramePhase::Input:
+            return "input";
+        case FramePhase::Update:
+            return "update";
+        case FramePhase::Step:
+            return "step";
+        case FramePhase::Render:
+            return "render";
+        case FramePhase::Upload:
+            return "upload";
+        case FramePhase::Draw:
+            return "draw";
+        case FramePhase::Swap:
+            return "swap";
+        case FramePhase::GpuClear:
+            return "gpu_clear";
+        case FramePhase::GpuUpload:
+            return "gpu_upload";
+        case FramePhase::GpuDraw:
+            return "gpu_draw";
+        case FramePhase::Count:
+            break;
+        }
+        return "unknown";
+    }
+
+    FrameProfiler& FrameProfiler::get() {
+        static FrameProfiler instance;
+        return instance;
+    }
+
+    FrameProfiler::FrameProfiler()
+        : history_(HISTORY),
+          frame_start_(Clock::now()),
+          summary_start_(frame_start_) {
+        scratch_.reserve(HISTORY);
+    }
+
+    void FrameProfiler::add(const FramePhase phase, const Clock::duration elapsed) {
+        const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        pending_[static_cast<std::size_t>(phase)].fetch_add(nanoseconds, std::memory_order_relaxed);
+    }
+
+    void FrameProfiler::end_frame() {
+        const auto now = Clock::now();
+
+        auto& record = history_[next_];
+        record.seconds = std::chrono::duration<double>(now - frame_start_).count();
+        for (std::size_t i = 0; i < FRAME_PHASE_COUNT; i++) {
+            record.phases[i] = static_cast<double>(pending_[i].exchange(0, std::memory_order_relaxed)) * 1e-9;
+        }
+
+        next_ = (next_ + 1) % HISTORY;
+        size_ = std::min(size_ + 1, HISTORY);
+        frame_start_ = now;
+
+        summary_frames_++;
+        const auto summary_seconds = std::chrono::duration<double>(now - summary_start_).count();
+        if (summary_seconds > 1.0) {
+            print_summary(summary_seconds);
+            summary_start_ = now;
+            summary_frames_ = 0;
+        }
+    }
+
+    template <typename Value>
+    FrameProfiler::Percentiles FrameProfiler::percentiles(const Value& value) const {
+        if (size_ == 0) {
+            return {};
+        }
+
+        scratch_.clear();
+        for (std::size_t i = 0; i < size_; i++) {
+            scratch_.push_back(value(history_[i]));
+        }
+        std::sort(scratch_.begin(), scratch_.end());
+
+        // Nearest rank
+        const auto rank = [&](const double percentile) {
+            const auto index = static_cast<std::size_t>(percentile * static_cast<double>(size_ - 1) + 0.5);
+            return scratch_[index];
+        };
+        return {rank(0.50), rank(0.95), rank(0.99), scratch_.back()};
+    }
+
+    FrameProfiler::Percentiles FrameProfiler::frame_percentiles() const {
+        return percentiles([](const FrameRecord& record) { return record.seconds; });
+    }
+
+    FrameProfiler::Percentiles FrameProfiler::phase_percentiles(const FramePhase phase) const {
+        const auto index = static_cast<std::size_t>(phase);
+        return percentiles([index](const FrameRecord& record) { return record.phases[index]; });
+    }
+
+    void FrameProfiler::dump(std::ostream& out) const {
+        const auto flags = out.flags();
+        const auto precision = out.precision();
+        out << std::fixed << std::setprecision(3);
+
+        const auto row = [&](const char* name, const Percentiles& p) {
+            out << std::left << std::setw(12) << name << std::right
+                << std::setw(10) << p.p50 * MILLISECONDS
+                << std::setw(10) << p.p95 * MILLISECONDS
+                << std::setw(10) << p.p99 * MILLISECONDS
+                << std::setw(10) << p.max * MILLISECONDS << '\n';
+        };
+
+        out << "Last " << size_ << " frames, ms\n"
+            << std::left << std::setw(12) << "phase" << std::right
+            << std::setw(10) << "p50" << std::setw(10) << "p95" << std::setw(10) << "p99" << std::setw(10) << "max"
+            << '\n';
+        row("frame", frame_percentiles());
+        for (std::size_t i = 0; i < FRAME_PHASE_COUNT; i++) {
+            const auto phase = static_cast<FramePhase>(i);
+            if (phase != FramePhase::Other) {
+                row(to_string(phase), phase_percentiles(phase));
+            }
+        }
+
+        out.flags(flags);
+        out.precision(precision);
+    }
+
+    void FrameProfiler::write_history(std::ostream& out) const {
+        out << "frame_ms";
+        for (std::size_t i = 0; i < FRAME_PHASE_COUNT; i++) {
+            out << ',' << to_string(static_cast<FramePhase>(i)) << "_ms";
+        }
+        out << '\n';
+
+        const auto first = (next_ + HISTORY - size_) % HISTORY;
+        for (std::size_t i = 0; i < size_; i++) {
+            const auto& record = history_[(first + i) % HISTORY];
+            out << record.seconds * MILLISECONDS;
+            for (const auto seconds : record.phases) {
+                out << ',' << seconds * MILLISECONDS;
+            }
+            out << '\n';
+        }
+    }
+
+    void FrameProfiler::print_summary(const double seconds) {
+        const auto frame = frame_percentiles();
+        std::cout << "FPS: " << summary_frames_ / seconds
+                  << " | frame ms p50 " << frame.p50 * MILLISECONDS
+                  << " p95 " << frame.p95 * MILLISECONDS
+                  << " p99 " << frame.p99 * MILLISECONDS;
+
+        // The step runs on its own thread, so its allocations are per frame too rather than per generation
+        if constexpr (ALLOCATION_TRACKING) {
+            std::cout << " | allocations/frame:";
+            bool any = false;
+            for (std::size_t i = 0; i < FRAME_PHASE_COUNT; i++) {
+                const auto phase = static_cast<FramePhase>(i);
+                const auto stats = allocation_stats(phase);
+                const auto& last = summary_allocations_[i];
+                if (stats.count != last.count) {
+                    std::cout << ' ' << to_string(phase) << ' '
+                              << static_cast<double>(stats.count - last.count) / summary_frames_ << " ("
+                              << static_cast<double>(stats.bytes - last.bytes) / summary_frames_ << " B)";
+                    any = true;
+                }
+                summary_allocations_[i] = stats;
+            }
+            if (!any) {
+                std::cout << " none";
+            }
+        }
+
+        std::cout << '\n';
+    }
+}
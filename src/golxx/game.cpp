@@ -1,24 +1,43 @@
 #include "golxx/game.h"
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <vector>
 #include "golxx/application.h"
 #include "golxx/camera.h"
 #include "golxx/config_manager.h"
 #include "golxx/engine.h"
-#include "golxx/fps_counter.h"
+#include "golxx/frame_profiler.h"
 #include "golxx/game_object.h"
+#include "golxx/generation_stats.h"
+#include "golxx/gpu_timer.h"
 #include "golxx/grid_renderer.h"
 #include "golxx/input.h"
+#include "golxx/pattern_io.h"
 #include "golxx/player.h"
+#include "golxx/simulation_worker.h"
 #include "golxx/simulator.h"
 #include "golxx/time_manager.h"
+#include "golxx/trace_recorder.h"
 
 
 namespace golxx {
-    Game::Game(Application& application, Engine& engine)
+    namespace {
+        constexpr auto DEFAULT_PATTERN_FILE = "golxx.rle";
+        constexpr auto FRAME_HISTORY_FILE = "golxx_frames.csv";
+        constexpr auto TRACE_FILE = "golxx_trace.json";
+        constexpr auto GENERATION_STATS_FILE = "golxx_generations.csv";
+        constexpr auto AUTO_ENGINE = "auto";
+    }
+
+    Game::Game(Application& application, Engine& engine, const std::string& pattern_file,
+               const std::string& simulation_engine)
         : application_(application),
           engine_(engine),
-          window_(application_.getWindow()) {
+          window_(application_.getWindow()),
+          pattern_file_(pattern_file.empty() ? DEFAULT_PATTERN_FILE : pattern_file) {
         window_.keyEvent.set(
             [](const glfw::KeyCode key, int, const glfw::KeyAction action, glfw::ModifierKeyBit) {
                 Input::HandleKey(key, action);
@@ -49,12 +68,39 @@ namespace golxx {
         int w_width, w_height;
         window_.getWindowSize(&w_width, &w_height);
 
-        simulator_ = std::make_shared<Simulator>();
+        // "auto" starts on the tile engine and leaves the rest to the simulator
+        const auto& engine_name = simulation_engine.empty() ? config.engine : simulation_engine;
+        const bool auto_engine = engine_name == AUTO_ENGINE;
+        auto engine_type = SimulationEngineType::BitTile;
+        if (!auto_engine) {
+            try {
+                engine_type = parse_simulation_engine(engine_name);
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << ", falling back to " << to_string(engine_type) << '\n';
+            }
+        }
+
+        simulator_ = std::make_shared<Simulator>(
+            engine_type,
+            static_cast<unsigned int>(std::max(config.simulationThreads, 0)));
+        simulator_->set_auto_engine(auto_engine);
+        try {
+            simulator_->set_rule(LifeRule::parse(config.rule));
+        } catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << ", falling back to " << simulator_->getRule().to_string() << '\n';
+        }
+        if (!pattern_file.empty()) {
+            golxx::load_pattern(pattern_file_, *simulator_);
+        }
+        simulation_worker_ = std::make_shared<SimulationWorker>(simulator_, config.generationsPerSecond);
         camera_ = std::make_shared<Camera>(20.0f, glm::vec2(w_width, w_height));
-        gameObjects_.emplace_back(std::make_shared<Player>(camera_, simulator_, config.playerSpeed));
+        gpu_timer_ = std::make_shared<GpuTimer>();
+        gameObjects_.emplace_back(std::make_shared<Player>(camera_, simulation_worker_, config.playerSpeed));
         gameObjects_.emplace_back(std::make_shared<GridRenderer>(
-            simulator_,
-            config.liveCellColor));
+            simulation_worker_,
+            gpu_timer_,
+            config.liveCellColor,
+            config.backgroundColor));
 
         camera_->set_size({w_width, w_height});
 
@@ -67,14 +113,20 @@ namespace golxx {
 
     void Game::run() {
         TimeManager timeManager;
-        FPSCounter fpsCounter;
+        auto& profiler = FrameProfiler::get();
+        TraceRecorder::get().set_thread_name("main");
 
         while (!window_.shouldClose()) {
-            glfwPollEvents();
-            Input::Update();
+            {
+                ProfileScope scope(FramePhase::Poll);
+                glfwPollEvents();
+            }
+            {
+                ProfileScope scope(FramePhase::Input);
+                Input::Update();
+            }
 
             const auto deltaTime = timeManager.getDeltaTime();
-            fpsCounter.update();
 
             update(deltaTime);
             render();
@@ -83,24 +135,135 @@ namespace golxx {
                 window_.setShouldClose(true);
             }
 
-            window_.swapBuffers();
+            {
+                ProfileScope scope(FramePhase::Swap);
+                window_.swapBuffers();
+            }
+
+            gpu_timer_->end_frame();
+            profiler.end_frame();
         }
     }
 
     void Game::update(const float deltaTime) {
+        ProfileScope scope(FramePhase::Update);
+
         for (const auto& gameObject : gameObjects_) {
             gameObject->update(deltaTime);
         }
 
-        if (Input::GetKeyPressed(glfw::KeyCode::Space) || Input::GetKeyDown(glfw::KeyCode::LeftShift)) {
-            simulator_->run_cycle();
+        simulation_worker_->set_running(Input::GetKeyPressed(glfw::KeyCode::Space));
+        if (Input::GetKeyDown(glfw::KeyCode::LeftShift)) {
+            simulation_worker_->request_step();
+        }
+        if (Input::GetKeyDown(glfw::KeyCode::F5)) {
+            save_pattern();
+        }
+        if (Input::GetKeyDown(glfw::KeyCode::F9)) {
+            reload_pattern();
+        }
+        if (Input::GetKeyDown(glfw::KeyCode::F3)) {
+            dump_profile();
+        }
+        if (Input::GetKeyDown(glfw::KeyCode::F2)) {
+            toggle_trace();
+        }
+        if (Input::GetKeyDown(glfw::KeyCode::F4)) {
+            toggle_generation_stats();
         }
     }
 
+    void Game::dump_profile() {
+        const auto& profiler = FrameProfiler::get();
+        profiler.dump(std::cout);
+
+        std::ofstream history(FRAME_HISTORY_FILE);
+        if (!history.is_open()) {
+            std::cerr << "Failed to write frame history: " << FRAME_HISTORY_FILE << '\n';
+            return;
+        }
+        profiler.write_history(history);
+        std::cout << "Wrote the last frames to " << FRAME_HISTORY_FILE << '\n';
+    }
+
+    void Game::toggle_trace() {
+        auto& trace = TraceRecorder::get();
+        if (!trace.recording()) {
+            trace.start(TRACE_FILE);
+            std::cout << "Recording a trace, press F2 again to stop\n";
+            return;
+        }
+
+        try {
+            trace.stop();
+            std::cout << "Wrote the trace to " << trace.getFilename() << '\n';
+        } catch (const std::runtime_error& e) {
+            std::cerr << e.what() << '\n';
+        }
+    }
+
+    void Game::toggle_generation_stats() {
+        // Decided on the simulation thread, where a writer that failed to open left no callback behind
+        simulation_worker_->submit([](Simulator& simulator) {
+            if (simulator.hasStatsCallback()) {
+                simulator.set_stats_callback({});
+                std::cout << "Stopped writing generation stats\n";
+                return;
+            }
+
+            try {
+                // The callback owns the writer, so the file is closed once the callback is replaced
+                auto writer = std::make_shared<GenerationStatsWriter>(GENERATION_STATS_FILE);
+                simulator.set_stats_callback([writer](const GenerationStats& stats) {
+                    writer->write(stats);
+                });
+                std::cout << "Writing generation stats to " << writer->getFilename() << ", press F4 again to stop\n";
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << '\n';
+            }
+        });
+    }
+
+    void Game::save_pattern() {
+        simulation_worker_->submit([file = pattern_file_](const Simulator& simulator) {
+            try {
+                golxx::save_pattern(file, simulator);
+                std::cout << "Saved " << simulator.getPopulation() << " cells to " << file << '\n';
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << '\n';
+            }
+        });
+    }
+
+    void Game::reload_pattern() {
+        simulation_worker_->submit([file = pattern_file_](Simulator& simulator) {
+            try {
+                // The pattern is read into a scratch universe first, so a missing or broken file leaves
+                // the live one untouched
+                Simulator loaded(simulator.getEngineType(), 1);
+                loaded.set_rule(simulator.getRule());
+                golxx::load_pattern(file, loaded);
+
+                std::vector<glm::i64vec2> cells;
+                loaded.collect_cells(loaded.bounds(), cells);
+                simulator.clear();
+                simulator.set_rule(loaded.getRule());
+                simulator.insert_cells(cells);
+                std::cout << "Loaded " << simulator.getPopulation() << " cells from " << file << '\n';
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << '\n';
+            }
+        });
+    }
+
     void Game::render() {
+        ProfileScope scope(FramePhase::Render);
         const auto& config = ConfigManager::get().getConfig();
 
-        glad::ClearBuffers().Color().Depth();
+        {
+            GpuTimerScope gpu_scope(*gpu_timer_, FramePhase::GpuClear);
+            glad::ClearBuffers().Color().Depth();
+        }
         const auto& bgColor = config.backgroundColor;
         glad::ClearColor(bgColor.r, bgColor.g, bgColor.b);
 
@@ -0,0 +1,84 @@
+#include "golxx/generation_stats.h"
+
+#include <stdexcept>
+#include "golxx/file_extension.h"
+
+namespace golxx {
+    namespace {
+        constexpr double MILLISECONDS = 1000.0;
+    }
+
+    GenerationStatsWriter::GenerationStatsWriter(const std::string& filename)
+        : filename_(filename),
+          out_(filename),
+          json_(has_extension(filename, ".ndjson") || has_extension(filename, ".jsonl")) {
+        if (!out_.is_open()) {
+            throw std::runtime_error("Failed to write generation stats: " + filename_);
+        }
+
+        if (!json_) {
+            out_ << "generation,generations,population,births,deaths,min_x,min_y,max_x,max_y,"
+                    "active_tiles,step_ms,memory_bytes\n";
+        }
+    }
+
+    void GenerationStatsWriter::write(const GenerationStats& stats) {
+        if (json_) {
+            write_json(stats);
+        }
+        else {
+            write_csv(stats);
+        }
+    }
+
+    void GenerationStatsWriter::write_csv(const GenerationStats& stats) {
+        out_ << stats.generation << ',' << stats.generations << ',' << stats.population << ',';
+        if (stats.births) {
+            out_ << *stats.births;
+        }
+        out_ << ',';
+        if (stats.deaths) {
+            out_ << *stats.deaths;
+        }
+        out_ << ',';
+        if (!stats.bounds.empty()) {
+            out_ << stats.bounds.min.x << ',' << stats.bounds.min.y << ','
+                 << stats.bounds.max.x << ',' << stats.bounds.max.y;
+        }
+        else {
+            out_ << ",,,";
+        }
+        out_ << ',' << stats.active_tiles << ',' << stats.step_seconds * MILLISECONDS << ','
+             << stats.memory_bytes << '\n';
+    }
+
+    void GenerationStatsWriter::write_json(const GenerationStats& stats) {
+        const auto optional = [this](const std::optional<std::uint64_t>& value) {
+            if (value) {
+                out_ << *value;
+            }
+            else {
+                out_ << "null";
+            }
+        };
+
+        out_ << R"({"generation": )" << stats.generation
+             << R"(, "generations": )" << stats.generations
+             << R"(, "population": )" << stats.population
+             << R"(, "births": )";
+        optional(stats.births);
+        out_ << R"(, "deaths": )";
+        optional(stats.deaths);
+        out_ << R"(, "bounds": )";
+        if (!stats.bounds.empty()) {
+            out_ << R"({"min_x": )" << stats.bounds.min.x << R"(, "min_y": )" << stats.bounds.min.y
+                 << R"(, "max_x": )" << stats.bounds.max.x << R"(, "max_y": )" << stats.bounds.max.y << '}';
+        }
+        else {
+            out_ << "null";
+        }
+        out_ << R"(, "active_tiles": )" << stats.active_tiles
+             << R"(, "step_ms": )" << stats.step_seconds * MILLISECONDS
+             << R"(, "memory_bytes": )" << stats.memory_bytes << "}\n";
+    }
+}
@@ -0,0 +1,61 @@
+#include "golxx/gpu_timer.h"
+
+#include <chrono>
+#include "golxx/frame_profiler.h"
+
+namespace golxx {
+    GpuTimer::~GpuTimer() {
+        for (const auto& queries : frames_) {
+            for (const auto& query : queries) {
+                glDeleteQueries(1, &query.id);
+            }
+        }
+        if (!free_queries_.empty()) {
+            glDeleteQueries(static_cast<GLsizei>(free_queries_.size()), free_queries_.data());
+        }
+    }
+
+    bool GpuTimer::begin(const FramePhase phase) {
+        if (running_) {
+            return false;
+        }
+
+        GLuint id = 0;
+        if (free_queries_.empty()) {
+            glGenQueries(1, &id);
+        }
+        else {
+            id = free_queries_.back();
+            free_queries_.pop_back();
+        }
+
+        glBeginQuery(GL_TIME_ELAPSED, id);
+        frames_[frame_].push_back({id, phase});
+        running_ = true;
+        return true;
+    }
+
+    void GpuTimer::end() {
+        glEndQuery(GL_TIME_ELAPSED);
+        running_ = false;
+    }
+
+    void GpuTimer::end_frame() {
+        // The slot after the current one was filled LATENCY frames ago
+        frame_ = (frame_ + 1) % frames_.size();
+
+        auto& profiler = FrameProfiler::get();
+        auto& queries = frames_[frame_];
+        for (const auto& query : queries) {
+            GLint available = 0;
+            glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available) {
+                GLuint64 nanoseconds = 0;
+                glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &nanoseconds);
+                profiler.add(query.phase, std::chrono::nanoseconds(nanoseconds));
+            }
+            free_queries_.push_back(query.id);
+        }
+        queries.clear();
+    }
+}
@@ -1,5 +1,11 @@
 #include "golxx/grid_renderer.h"
 
+#include <array>
+#include <cmath>
+#include <iostream>
+#include "golxx/frame_profiler.h"
+#include "golxx/trace_recorder.h"
+
 namespace golxx {
     auto vertex_shader_source = R"(
 #version 330 core
@@ -30,54 +36,351 @@ void main() {
     FragColor = vec4(color, 1.0);
 })";
 
+    auto bitmap_vertex_shader_source = R"(
+#version 330 core
+
+layout (location = 0) in vec3 a_position;
+layout (location = 2) in vec2 a_uv;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec2 v_uv;
+
+void main() {
+    v_uv = a_uv;
+    gl_Position = projection * view * model * vec4(a_position, 1.0);
+})";
+
+    // Mipmaps average the cells under a pixel once cells get smaller than pixels
+    auto bitmap_fragment_shader_source = R"(
+#version 330 core
+
+in vec2 v_uv;
+
+out vec4 FragColor;
+
+uniform vec3 color;
+uniform vec3 background;
+uniform sampler2D cells;
+
+void main() {
+    FragColor = vec4(mix(background, color, texture(cells, v_uv).r), 1.0);
+})";
+
+    // Slot s of the atlas holds tile rows at texel column (s % 64) * 2, low word first, and row (s / 64) * 64
+    auto tile_vertex_shader_source = R"(
+#version 330 core
+
+layout (location = 0) in vec3 a_position;
+layout (location = 3) in vec2 a_origin;
+layout (location = 4) in float a_slot;
+
+uniform mat4 view;
+uniform mat4 projection;
+
+out vec2 v_cell;
+flat out int v_slot;
+
+void main() {
+    v_cell = (a_position.xy + 0.5) * 64.0;
+    v_slot = int(a_slot);
+    gl_Position = projection * view * vec4(a_origin + v_cell, 0.0, 1.0);
+})";
+
+    auto tile_fragment_shader_source = R"(
+#version 330 core
+
+in vec2 v_cell;
+flat in int v_slot;
+
+out vec4 FragColor;
+
+uniform vec3 color;
+uniform usampler2D tiles;
+
+void main() {
+    ivec2 cell = clamp(ivec2(floor(v_cell)), ivec2(0), ivec2(63));
+    ivec2 texel = ivec2((v_slot % 64) * 2 + (cell.x >> 5), (v_slot / 64) * 64 + cell.y);
+    if (((texelFetch(tiles, texel, 0).r >> uint(cell.x & 31)) & 1u) == 0u) {
+        discard;
+    }
+    FragColor = vec4(color, 1.0);
+})";
+
     struct CellVertex {
         glm::vec3 position;
         glm::vec3 normal;
         glm::vec2 uv;
     };
 
-    struct CellInstanceData {
-        glm::vec2 position;
-    };
+    // Switch to tiles once live cells' instance data outweighs a bit per visible cell,
+    // and back only at half that density so a view near the threshold does not flip every frame
+    constexpr double TILES_ENTER_DENSITY = 1.0 / (8.0 * sizeof(CellInstanceData));
+    constexpr double TILES_LEAVE_DENSITY = TILES_ENTER_DENSITY / 2.0;
+
+    // A view that needs no density bitmap spans fewer than 2048 cells, so at most 33x33 tiles
+    constexpr int TILE_ATLAS_COLUMNS = 64;
+    constexpr int TILE_ATLAS_ROWS = 32;
+
+    namespace {
+        // Instance positions are uploaded relative to anchor, and only the anchor's distance to the camera
+        // reaches the GPU, so both stay small wherever in the universe the view is
+        glm::mat4 anchored_view(const Camera& camera, const glm::i64vec2 anchor) {
+            const auto offset = glm::vec3(glm::vec2(anchor - camera.origin), 0.0f) - camera.position;
+            return glm::translate(glm::identity<glm::mat4>(), offset);
+        }
+    }
+
+    GridRenderer::~GridRenderer() {
+        if (bitmap_texture_) {
+            glDeleteTextures(1, &bitmap_texture_);
+        }
+        if (tile_texture_) {
+            glDeleteTextures(1, &tile_texture_);
+        }
+    }
 
     void GridRenderer::init() {
         init_mesh();
         init_shaders();
+        init_bitmap_texture();
+        init_tile_atlas();
     }
 
     void GridRenderer::update(float deltaTime) {}
 
 
     void GridRenderer::render(const std::shared_ptr<Camera>& camera) {
+        for (auto* program : {shader_program_.get(), bitmap_shader_program_.get(), tile_shader_program_.get()}) {
+            glad::Bind(*program);
+            glad::UniformMat4(*program, "projection").set(glm::value_ptr(camera->get_projection()));
+        }
+
+        // Only what is on screen is pulled from the simulation; a moved camera is caught up next frame
+        const auto region = camera->visible_region();
+        const auto snapshot = simulation_worker_->getSnapshot();
+        format_ = choose_format(*snapshot, region);
+        simulation_worker_->set_view(region, format_);
+
+        // Snapshots of the paths not drawn are let go, so the worker can refill them
+        if (snapshot->format == SnapshotFormat::Bitmap) {
+            cells_snapshot_.reset();
+            tiles_snapshot_.reset();
+            render_bitmap(snapshot, *camera);
+        }
+        else if (snapshot->format == SnapshotFormat::Tiles) {
+            bitmap_snapshot_.reset();
+            cells_snapshot_.reset();
+            render_tiles(snapshot, *camera);
+        }
+        else {
+            bitmap_snapshot_.reset();
+            tiles_snapshot_.reset();
+            render_cells(snapshot, *camera);
+        }
+    }
+
+    SnapshotFormat GridRenderer::choose_format(const SimulationSnapshot& snapshot, const CellRegion& region) const {
+        if (region.empty()) {
+            return SnapshotFormat::Cells;
+        }
+
+        // Zoomed out this far cells are smaller than a pixel: only density blocks make sense
+        if (SimulationSnapshot::bitmap_shift(region) > 0) {
+            return SnapshotFormat::Bitmap;
+        }
+        if (snapshot.region.empty()) {
+            return SnapshotFormat::Cells;
+        }
+
+        const auto density = static_cast<double>(snapshot.population) / static_cast<double>(snapshot.region.area());
+        const auto threshold = format_ == SnapshotFormat::Tiles ? TILES_LEAVE_DENSITY : TILES_ENTER_DENSITY;
+        return density >= threshold ? SnapshotFormat::Tiles : SnapshotFormat::Cells;
+    }
+
+    void GridRenderer::render_cells(const std::shared_ptr<const SimulationSnapshot>& snapshot, const Camera& camera) {
         glad::Bind(*shader_program_);
-        glad::UniformMat4(*shader_program_, "projection").set(glm::value_ptr(camera->get_projection()));
-        const auto view = glm::translate(glm::identity<glm::mat4>(), -camera->position);
-        glad::UniformMat4(*shader_program_, "view").set(glm::value_ptr(view));
         auto model = glm::identity<glm::mat4>();
         model = glm::scale(model, glm::vec3(1.0f));
         model = glm::translate(model, glm::vec3(0.5f));
         glad::UniformMat4(*shader_program_, "model").set(glm::value_ptr(model));
+        const auto view = anchored_view(camera, snapshot->region.min);
+        glad::UniformMat4(*shader_program_, "view").set(glm::value_ptr(view));
 
-        std::vector<CellInstanceData> cells(simulator_->getCells().size());
-        unsigned i = 0;
-        for (const auto& liveCell : simulator_->getCells()) {
-            cells[i++] = {
-                .position = liveCell
-            };
+        // A paused simulation keeps publishing the same snapshot, which is already in the buffer
+        if (snapshot != cells_snapshot_) {
+            ProfileScope scope(FramePhase::Upload);
+            GpuTimerScope gpu_scope(*gpu_timer_, FramePhase::GpuUpload);
+            TraceScope trace("cell_upload", "gl");
+            cell_instances_.clear();
+            for (const auto& liveCell : snapshot->cells) {
+                cell_instances_.push_back({
+                    .position = glm::vec2(liveCell - snapshot->region.min)
+                });
+            }
+
+            instance_array_buffer_->data(
+                sizeof(CellInstanceData) * cell_instances_.size(),
+                cell_instances_.data(),
+                glad::BufferUsage::DynamicDraw
+            );
+            trace.set_arg("bytes", static_cast<std::int64_t>(sizeof(CellInstanceData) * cell_instances_.size()));
+            cells_snapshot_ = snapshot;
         }
 
-        instance_array_buffer_->data(
-            sizeof(CellInstanceData) * cells.size(),
-            cells.data(),
+        ProfileScope scope(FramePhase::Draw);
+        GpuTimerScope gpu_scope(*gpu_timer_, FramePhase::GpuDraw);
+        glad::Bind(*vertex_array_);
+        glad::DrawElementsInstanced(
+            glad::PrimitiveType::Triangles,
+            6,
+            glad::IndexType::UnsignedInt,
+            snapshot->cells.size()
+        );
+    }
+
+    void GridRenderer::render_tiles(const std::shared_ptr<const SimulationSnapshot>& snapshot, const Camera& camera) {
+        if (snapshot != tiles_snapshot_) {
+            ProfileScope scope(FramePhase::Upload);
+            GpuTimerScope gpu_scope(*gpu_timer_, FramePhase::GpuUpload);
+            TraceScope trace("tile_upload", "gl");
+            trace.set_arg("tiles", update_tile_atlas(*snapshot));
+            tiles_snapshot_ = snapshot;
+        }
+
+        ProfileScope scope(FramePhase::Draw);
+        GpuTimerScope gpu_scope(*gpu_timer_, FramePhase::GpuDraw);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, tile_texture_);
+
+        glad::Bind(*tile_shader_program_);
+        const auto view = anchored_view(camera, snapshot->region.min);
+        glad::UniformMat4(*tile_shader_program_, "view").set(glm::value_ptr(view));
+        glad::Bind(*tile_vertex_array_);
+        glad::DrawElementsInstanced(
+            glad::PrimitiveType::Triangles,
+            6,
+            glad::IndexType::UnsignedInt,
+            tile_instance_count_
+        );
+    }
+
+    std::int64_t GridRenderer::update_tile_atlas(const SimulationSnapshot& snapshot) {
+        tile_epoch_++;
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, tile_texture_);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+        tile_instances_.clear();
+        std::array<GLuint, 2 * CellTile::SIZE> texels{};
+        std::int64_t uploaded = 0;
+
+        for (const auto& tile : snapshot.tiles) {
+            auto it = tile_slots_.find(tile.key);
+            if (it == tile_slots_.end()) {
+                if (free_tile_slots_.empty()) {
+                    std::cerr << "Tile atlas is full, skipping tile " << tile.key.x << ", " << tile.key.y << std::endl;
+                    continue;
+                }
+
+                // Stamps start at 1, so a fresh slot always uploads
+                it = tile_slot_nodes_.emplace(tile_slots_, tile.key).first;
+                it->second = {free_tile_slots_.back(), 0, 0};
+                free_tile_slots_.pop_back();
+            }
+
+            auto& slot = it->second;
+            slot.epoch = tile_epoch_;
+            if (slot.stamp != tile.stamp) {
+                for (int y = 0; y < CellTile::SIZE; y++) {
+                    texels[2 * y] = static_cast<GLuint>(tile.rows[y]);
+                    texels[2 * y + 1] = static_cast<GLuint>(tile.rows[y] >> 32);
+                }
+
+                glTexSubImage2D(GL_TEXTURE_2D, 0,
+                                static_cast<GLint>(slot.index % TILE_ATLAS_COLUMNS) * 2,
+                                static_cast<GLint>(slot.index / TILE_ATLAS_COLUMNS) * CellTile::SIZE,
+                                2, CellTile::SIZE, GL_RED_INTEGER, GL_UNSIGNED_INT, texels.data());
+                slot.stamp = tile.stamp;
+                uploaded++;
+            }
+
+            const glm::i64vec2 origin(tile.key.x * CellTile::SIZE, tile.key.y * CellTile::SIZE);
+            tile_instances_.push_back({glm::vec2(origin - snapshot.region.min), static_cast<float>(slot.index)});
+        }
+
+        // Tiles that left the view or died give their slot back
+        if (tile_slots_.size() > tile_instances_.size()) {
+            for (auto it = tile_slots_.begin(); it != tile_slots_.end();) {
+                if (it->second.epoch != tile_epoch_) {
+                    free_tile_slots_.push_back(it->second.index);
+                    it = tile_slot_nodes_.erase(tile_slots_, it);
+                }
+                else {
+                    ++it;
+                }
+            }
+        }
+
+        tile_instance_buffer_->data(
+            sizeof(TileInstanceData) * tile_instances_.size(),
+            tile_instances_.data(),
             glad::BufferUsage::DynamicDraw
         );
+        tile_instance_count_ = static_cast<GLsizei>(tile_instances_.size());
+        return uploaded;
+    }
 
-        glad::Bind(*vertex_array_);
+    void GridRenderer::render_bitmap(const std::shared_ptr<const SimulationSnapshot>& snapshot, const Camera& camera) {
+        const auto blocks = snapshot->bitmap_blocks();
+        const glm::ivec2 size(static_cast<int>(blocks.max.x - blocks.min.x + 1),
+                              static_cast<int>(blocks.max.y - blocks.min.y + 1));
+        const auto block_size = std::ldexp(1.0f, static_cast<int>(snapshot->block_shift));
+
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, bitmap_texture_);
+
+        // Snapshots are immutable, so the texture only changes along with the snapshot
+        if (snapshot != bitmap_snapshot_) {
+            ProfileScope scope(FramePhase::Upload);
+            GpuTimerScope gpu_scope(*gpu_timer_, FramePhase::GpuUpload);
+            TraceScope trace("bitmap_upload", "gl");
+            trace.set_arg("bytes", static_cast<std::int64_t>(snapshot->bitmap.size()));
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            if (size != bitmap_texture_size_) {
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, size.x, size.y, 0,
+                             GL_RED, GL_UNSIGNED_BYTE, snapshot->bitmap.data());
+                bitmap_texture_size_ = size;
+            }
+            else {
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.x, size.y,
+                                GL_RED, GL_UNSIGNED_BYTE, snapshot->bitmap.data());
+            }
+            glGenerateMipmap(GL_TEXTURE_2D);
+            bitmap_snapshot_ = snapshot;
+        }
+
+        ProfileScope scope(FramePhase::Draw);
+        GpuTimerScope gpu_scope(*gpu_timer_, FramePhase::GpuDraw);
+        glad::Bind(*bitmap_shader_program_);
+        const auto cells_per_block = std::int64_t{1} << snapshot->block_shift;
+        const glm::i64vec2 corner(blocks.min.x * cells_per_block, blocks.min.y * cells_per_block);
+        const auto view = anchored_view(camera, corner);
+        glad::UniformMat4(*bitmap_shader_program_, "view").set(glm::value_ptr(view));
+        auto model = glm::identity<glm::mat4>();
+        model = glm::scale(model, glm::vec3(glm::vec2(size) * block_size, 1.0f));
+        model = glm::translate(model, glm::vec3(0.5f, 0.5f, 0.0f));
+        glad::UniformMat4(*bitmap_shader_program_, "model").set(glm::value_ptr(model));
+
+        glad::Bind(*bitmap_vertex_array_);
         glad::DrawElementsInstanced(
             glad::PrimitiveType::Triangles,
             6,
             glad::IndexType::UnsignedInt,
-            cells.size()
+            1
         );
     }
 
@@ -154,6 +457,65 @@ void main() {
 
         glad::Unbind(*instance_array_buffer_);
         glad::Unbind(*vertex_array_);
+
+        // Same quad without the per-instance attribute
+        bitmap_vertex_array_ = std::make_unique<glad::VertexArray>();
+        glad::Bind(*bitmap_vertex_array_);
+        glad::Bind(*array_buffer_);
+        glad::Bind(*element_array_buffer_);
+
+        glad::VertexAttribute(0)
+            .pointer(3,
+                     glad::DataType::Float,
+                     false,
+                     sizeof(CellVertex),
+                     reinterpret_cast<GLvoid*>(offsetof(CellVertex, position)))
+            .enable();
+        glad::VertexAttribute(2)
+            .pointer(2,
+                     glad::DataType::Float,
+                     false,
+                     sizeof(CellVertex),
+                     reinterpret_cast<GLvoid*>(offsetof(CellVertex, uv)))
+            .enable();
+
+        glad::Unbind(*bitmap_vertex_array_);
+
+        // Same quad again, stretched over a tile per instance
+        tile_vertex_array_ = std::make_unique<glad::VertexArray>();
+        tile_instance_buffer_ = std::make_unique<glad::ArrayBuffer>();
+        glad::Bind(*tile_vertex_array_);
+        glad::Bind(*array_buffer_);
+        glad::Bind(*element_array_buffer_);
+
+        glad::VertexAttribute(0)
+            .pointer(3,
+                     glad::DataType::Float,
+                     false,
+                     sizeof(CellVertex),
+                     reinterpret_cast<GLvoid*>(offsetof(CellVertex, position)))
+            .enable();
+
+        glad::Bind(*tile_instance_buffer_);
+        glad::VertexAttribute(3)
+            .pointer(2,
+                     glad::DataType::Float,
+                     false,
+                     sizeof(TileInstanceData),
+                     reinterpret_cast<GLvoid*>(offsetof(TileInstanceData, origin)))
+            .divisor(1)
+            .enable();
+        glad::VertexAttribute(4)
+            .pointer(1,
+                     glad::DataType::Float,
+                     false,
+                     sizeof(TileInstanceData),
+                     reinterpret_cast<GLvoid*>(offsetof(TileInstanceData, slot)))
+            .divisor(1)
+            .enable();
+
+        glad::Unbind(*tile_instance_buffer_);
+        glad::Unbind(*tile_vertex_array_);
     }
 
     void GridRenderer::init_shaders() {
@@ -170,5 +532,57 @@ void main() {
 
         glad::Bind(*shader_program_);
         glad::UniformVec3(*shader_program_, "color").set(glm::value_ptr(live_cell_color_));
+
+        bitmap_shader_program_ = std::make_unique<glad::Program>();
+
+        auto bitmap_vertex_shader = glad::VertexShader();
+        bitmap_vertex_shader.set_source(bitmap_vertex_shader_source);
+
+        auto bitmap_fragment_shader = glad::FragmentShader();
+        bitmap_fragment_shader.set_source(bitmap_fragment_shader_source);
+
+        bitmap_shader_program_->attach_shader(bitmap_vertex_shader, bitmap_fragment_shader);
+        bitmap_shader_program_->link();
+
+        glad::Bind(*bitmap_shader_program_);
+        glad::UniformVec3(*bitmap_shader_program_, "color").set(glm::value_ptr(live_cell_color_));
+        glad::UniformVec3(*bitmap_shader_program_, "background").set(glm::value_ptr(background_color_));
+
+        tile_shader_program_ = std::make_unique<glad::Program>();
+
+        auto tile_vertex_shader = glad::VertexShader();
+        tile_vertex_shader.set_source(tile_vertex_shader_source);
+
+        auto tile_fragment_shader = glad::FragmentShader();
+        tile_fragment_shader.set_source(tile_fragment_shader_source);
+
+        tile_shader_program_->attach_shader(tile_vertex_shader, tile_fragment_shader);
+        tile_shader_program_->link();
+
+        glad::Bind(*tile_shader_program_);
+        glad::UniformVec3(*tile_shader_program_, "color").set(glm::value_ptr(live_cell_color_));
+    }
+
+    void GridRenderer::init_bitmap_texture() {
+        glGenTextures(1, &bitmap_texture_);
+        glBindTexture(GL_TEXTURE_2D, bitmap_texture_);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    void GridRenderer::init_tile_atlas() {
+        glGenTextures(1, &tile_texture_);
+        glBindTexture(GL_TEXTURE_2D, tile_texture_);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, TILE_ATLAS_COLUMNS * 2, TILE_ATLAS_ROWS * CellTile::SIZE, 0,
+                     GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+        // Handed out from the back, so slot 0 goes first
+        for (GLuint slot = TILE_ATLAS_COLUMNS * TILE_ATLAS_ROWS; slot > 0; slot--) {
+            free_tile_slots_.push_back(slot - 1);
+        }
     }
 }
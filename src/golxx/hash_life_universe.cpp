@@ -0,0 +1,504 @@
+#include "golxx/hash_life_universe.h"
+
+#include <algorithm>
+#include "golxx/generation_stats.h"
+
+namespace golxx {
+    namespace {
+        constexpr unsigned int INITIAL_ROOT_LEVEL = 3;
+        // A root of this level spans exactly the cell range, [-CELL_LIMIT, CELL_LIMIT) on both axes
+        constexpr unsigned int MAX_ROOT_LEVEL = 61;
+        static_assert(std::int64_t{1} << (MAX_ROOT_LEVEL - 1) == CELL_LIMIT);
+        constexpr std::size_t INITIAL_COLLECT_THRESHOLD = std::size_t{1} << 22;
+
+        std::uint64_t mix(std::uint64_t value) {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdULL;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ULL;
+            value ^= value >> 33;
+            return value;
+        }
+
+        bool next_state(const LifeRule& rule, const unsigned int grid, const int x, const int y) {
+            int count = 0;
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (dx || dy) {
+                        count += grid >> ((y + dy) * 4 + x + dx) & 1;
+                    }
+                }
+            }
+
+            const bool alive = grid >> (y * 4 + x) & 1;
+            return rule.next_state(alive, count);
+        }
+    }
+
+    std::size_t HashLifeUniverse::NodeKeyHash::operator()(const NodeKey& key) const {
+        const auto high = static_cast<std::uint64_t>(key.nw) << 32 | key.ne;
+        const auto low = static_cast<std::uint64_t>(key.sw) << 32 | key.se;
+        return static_cast<std::size_t>(mix(high ^ mix(low)));
+    }
+
+    HashLifeUniverse::HashLifeUniverse()
+        : root_(NO_NODE),
+          collect_threshold_(INITIAL_COLLECT_THRESHOLD) {
+        clear();
+    }
+
+    void HashLifeUniverse::set_rule(const LifeRule& rule) {
+        if (rule == rule_) {
+            return;
+        }
+
+        rule_ = rule;
+        for (auto& node : nodes_) {
+            node.result = NO_NODE;
+        }
+    }
+
+    void HashLifeUniverse::set_state(const glm::i64vec2 cell, const bool state) {
+        const auto inside = [&] {
+            const auto half = half_extent();
+            return cell.x >= -half && cell.x < half && cell.y >= -half && cell.y < half;
+        };
+
+        while (!inside()) {
+            root_ = centre(root_);
+        }
+
+        const auto half = half_extent();
+        root_ = set_cell(root_, cell.x + half, cell.y + half, state);
+    }
+
+    void HashLifeUniverse::set_cells(const std::vector<glm::i64vec2>& cells) {
+        if (cells.empty()) {
+            return;
+        }
+
+        auto min = cells.front();
+        auto max = cells.front();
+        for (const auto cell : cells) {
+            min = glm::min(min, cell);
+            max = glm::max(max, cell);
+        }
+
+        while (min.x < -half_extent() || min.y < -half_extent() || max.x >= half_extent() || max.y >= half_extent()) {
+            root_ = centre(root_);
+        }
+
+        cell_buffer_.assign(cells.begin(), cells.end());
+        const auto half = half_extent();
+        root_ = set_cells(root_, -half, -half, cell_buffer_.begin(), cell_buffer_.end());
+    }
+
+    bool HashLifeUniverse::get_state(const glm::i64vec2 cell) const {
+        const auto half = half_extent();
+        if (cell.x < -half || cell.x >= half || cell.y < -half || cell.y >= half) {
+            return false;
+        }
+
+        std::int64_t x = cell.x + half;
+        std::int64_t y = cell.y + half;
+        auto id = root_;
+        for (auto level = nodes_[root_].level; level > 0; level--) {
+            const auto& node = nodes_[id];
+            const auto child_half = std::int64_t{1} << (level - 1);
+            const bool east = x >= child_half;
+            const bool south = y >= child_half;
+            id = south ? (east ? node.se : node.sw) : (east ? node.ne : node.nw);
+            x -= east ? child_half : 0;
+            y -= south ? child_half : 0;
+        }
+
+        return id == LIVE_LEAF;
+    }
+
+    void HashLifeUniverse::step(const unsigned int exponent) {
+        // Pad until the pattern cannot escape the region the successor returns. The root stops growing at
+        // the edge of the cell range; cells stepping past it are lost.
+        while ((nodes_[root_].level < exponent + 2 || !is_padded(root_)) && nodes_[root_].level < MAX_ROOT_LEVEL) {
+            root_ = centre(root_);
+        }
+
+        root_ = successor(centre(root_), exponent);
+
+        if (nodes_.size() > collect_threshold_) {
+            collect_garbage();
+        }
+    }
+
+    void HashLifeUniverse::clear() {
+        nodes_.clear();
+        index_.clear();
+        empty_nodes_.clear();
+
+        nodes_.push_back({NO_NODE, NO_NODE, NO_NODE, NO_NODE, 0, NO_NODE, -1, 0});
+        nodes_.push_back({NO_NODE, NO_NODE, NO_NODE, NO_NODE, 1, NO_NODE, -1, 0});
+
+        root_ = empty_node(INITIAL_ROOT_LEVEL);
+    }
+
+    std::uint64_t HashLifeUniverse::population() const {
+        return nodes_[root_].population;
+    }
+
+    void HashLifeUniverse::collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const {
+        if (region.empty()) {
+            return;
+        }
+
+        const auto half = half_extent();
+        collect_cells(root_, -half, -half, region, cells);
+    }
+
+    void HashLifeUniverse::collect_density(const CellRegion& region, const unsigned int shift,
+                                           std::vector<DensityBlock>& blocks) const {
+        if (region.empty()) {
+            return;
+        }
+
+        const auto half = half_extent();
+        collect_density(root_, -half, -half, region, shift, blocks);
+    }
+
+    CellRegion HashLifeUniverse::bounds() const {
+        CellRegion bounds;
+        const auto half = half_extent();
+        extend_bounds(root_, -half, -half, bounds);
+        return bounds;
+    }
+
+    void HashLifeUniverse::fill_stats(GenerationStats& stats) const {
+        stats.bounds = bounds();
+        stats.memory_bytes = memory_usage();
+    }
+
+    std::size_t HashLifeUniverse::memory_usage() const {
+        return nodes_.capacity() * sizeof(Node) + hash_container_memory(index_) +
+            empty_nodes_.capacity() * sizeof(NodeId) + cell_buffer_.capacity() * sizeof(glm::i64vec2);
+    }
+
+    HashLifeUniverse::NodeId HashLifeUniverse::join(const NodeId nw, const NodeId ne, const NodeId sw, const NodeId se) {
+        const NodeKey key{nw, ne, sw, se};
+        if (const auto it = index_.find(key); it != index_.end()) {
+            return it->second;
+        }
+
+        const auto population = nodes_[nw].population + nodes_[ne].population +
+            nodes_[sw].population + nodes_[se].population;
+        const auto level = static_cast<std::uint8_t>(nodes_[nw].level + 1);
+
+        const auto id = static_cast<NodeId>(nodes_.size());
+        nodes_.push_back({nw, ne, sw, se, population, NO_NODE, -1, level});
+        index_.emplace(key, id);
+        return id;
+    }
+
+    HashLifeUniverse::NodeId HashLifeUniverse::empty_node(const unsigned int level) {
+        if (empty_nodes_.empty()) {
+            empty_nodes_.push_back(DEAD_LEAF);
+        }
+
+        while (empty_nodes_.size() <= level) {
+            const auto child = empty_nodes_.back();
+            empty_nodes_.push_back(join(child, child, child, child));
+        }
+
+        return empty_nodes_[level];
+    }
+
+    HashLifeUniverse::NodeId HashLifeUniverse::centre(const NodeId id) {
+        const auto node = nodes_[id];
+        const auto empty = empty_node(node.level - 1);
+
+        return join(
+            join(empty, empty, empty, node.nw),
+            join(empty, empty, node.ne, empty),
+            join(empty, node.sw, empty, empty),
+            join(node.se, empty, empty, empty));
+    }
+
+    bool HashLifeUniverse::is_padded(const NodeId id) const {
+        const auto& node = nodes_[id];
+        if (node.level < 2) {
+            return false;
+        }
+
+        const auto inner = nodes_[nodes_[node.nw].se].population + nodes_[nodes_[node.ne].sw].population +
+            nodes_[nodes_[node.sw].ne].population + nodes_[nodes_[node.se].nw].population;
+        return inner == node.population;
+    }
+
+    // Returns the center half of the node advanced by 2^exponent generations,
+    // capped at 2^(level - 2) which is the furthest the node can see.
+    HashLifeUniverse::NodeId HashLifeUniverse::successor(const NodeId id, const unsigned int exponent) {
+        const auto node = nodes_[id];
+        const auto step_exponent = std::min<int>(static_cast<int>(exponent), node.level - 2);
+
+        if (node.result != NO_NODE && node.result_exponent == step_exponent) {
+            return node.result;
+        }
+
+        NodeId result;
+        if (node.population == 0) {
+            result = empty_node(node.level - 1);
+        }
+        else if (node.level == 2) {
+            result = step_base(id);
+        }
+        else {
+            const auto a = nodes_[node.nw];
+            const auto b = nodes_[node.ne];
+            const auto c = nodes_[node.sw];
+            const auto d = nodes_[node.se];
+
+            // Nine overlapping sub-squares, each stepped to half size
+            const auto c1 = successor(node.nw, exponent);
+            const auto c2 = successor(join(a.ne, b.nw, a.se, b.sw), exponent);
+            const auto c3 = successor(node.ne, exponent);
+            const auto c4 = successor(join(a.sw, a.se, c.nw, c.ne), exponent);
+            const auto c5 = successor(join(a.se, b.sw, c.ne, d.nw), exponent);
+            const auto c6 = successor(join(b.sw, b.se, d.nw, d.ne), exponent);
+            const auto c7 = successor(node.sw, exponent);
+            const auto c8 = successor(join(c.ne, d.nw, c.se, d.sw), exponent);
+            const auto c9 = successor(node.se, exponent);
+
+            if (step_exponent < node.level - 2) {
+                // Already advanced far enough, just take the centers
+                const auto centre_of = [&](const NodeId nw, const NodeId ne, const NodeId sw, const NodeId se) {
+                    return join(nodes_[nw].se, nodes_[ne].sw, nodes_[sw].ne, nodes_[se].nw);
+                };
+
+                result = join(
+                    centre_of(c1, c2, c4, c5),
+                    centre_of(c2, c3, c5, c6),
+                    centre_of(c4, c5, c7, c8),
+                    centre_of(c5, c6, c8, c9));
+            }
+            else {
+                const auto nw = successor(join(c1, c2, c4, c5), exponent);
+                const auto ne = successor(join(c2, c3, c5, c6), exponent);
+                const auto sw = successor(join(c4, c5, c7, c8), exponent);
+                const auto se = successor(join(c5, c6, c8, c9), exponent);
+                result = join(nw, ne, sw, se);
+            }
+        }
+
+        nodes_[id].result = result;
+        nodes_[id].result_exponent = static_cast<std::int8_t>(step_exponent);
+        return result;
+    }
+
+    // Advances the center 2x2 of a 4x4 node by one generation
+    HashLifeUniverse::NodeId HashLifeUniverse::step_base(const NodeId id) {
+        const auto node = nodes_[id];
+
+        unsigned int grid = 0;
+        const auto put_quadrant = [&](const NodeId quadrant, const int x, const int y) {
+            const auto& q = nodes_[quadrant];
+            grid |= (q.nw == LIVE_LEAF) << (y * 4 + x);
+            grid |= (q.ne == LIVE_LEAF) << (y * 4 + x + 1);
+            grid |= (q.sw == LIVE_LEAF) << ((y + 1) * 4 + x);
+            grid |= (q.se == LIVE_LEAF) << ((y + 1) * 4 + x + 1);
+        };
+
+        put_quadrant(node.nw, 0, 0);
+        put_quadrant(node.ne, 2, 0);
+        put_quadrant(node.sw, 0, 2);
+        put_quadrant(node.se, 2, 2);
+
+        const auto leaf = [&](const int x, const int y) {
+            return next_state(rule_, grid, x, y) ? LIVE_LEAF : DEAD_LEAF;
+        };
+
+        return join(leaf(1, 1), leaf(2, 1), leaf(1, 2), leaf(2, 2));
+    }
+
+    HashLifeUniverse::NodeId HashLifeUniverse::set_cell(const NodeId id,
+                                                        const std::int64_t x,
+                                                        const std::int64_t y,
+                                                        const bool state) {
+        const auto node = nodes_[id];
+        if (node.level == 0) {
+            return state ? LIVE_LEAF : DEAD_LEAF;
+        }
+
+        const auto half = std::int64_t{1} << (node.level - 1);
+        const bool east = x >= half;
+        const bool south = y >= half;
+        const auto cx = east ? x - half : x;
+        const auto cy = south ? y - half : y;
+
+        if (south) {
+            return east
+                       ? join(node.nw, node.ne, node.sw, set_cell(node.se, cx, cy, state))
+                       : join(node.nw, node.ne, set_cell(node.sw, cx, cy, state), node.se);
+        }
+        return east
+                   ? join(node.nw, set_cell(node.ne, cx, cy, state), node.sw, node.se)
+                   : join(set_cell(node.nw, cx, cy, state), node.ne, node.sw, node.se);
+    }
+
+    // Cells are partitioned into the quadrants of the node whose top-left corner is (x, y)
+    HashLifeUniverse::NodeId HashLifeUniverse::set_cells(const NodeId id,
+                                                         const std::int64_t x,
+                                                         const std::int64_t y,
+                                                         const CellIterator begin,
+                                                         const CellIterator end) {
+        if (begin == end) {
+            return id;
+        }
+
+        const auto node = nodes_[id];
+        if (node.level == 0) {
+            return LIVE_LEAF;
+        }
+
+        const auto half = std::int64_t{1} << (node.level - 1);
+        const auto south = std::partition(begin, end, [&](const glm::i64vec2 cell) { return cell.y < y + half; });
+        const auto west_of = [&](const glm::i64vec2 cell) { return cell.x < x + half; };
+        const auto north_east = std::partition(begin, south, west_of);
+        const auto south_east = std::partition(south, end, west_of);
+
+        const auto nw = set_cells(node.nw, x, y, begin, north_east);
+        const auto ne = set_cells(node.ne, x + half, y, north_east, south);
+        const auto sw = set_cells(node.sw, x, y + half, south, south_east);
+        const auto se = set_cells(node.se, x + half, y + half, south_east, end);
+        return join(nw, ne, sw, se);
+    }
+
+    void HashLifeUniverse::collect_cells(const NodeId id,
+                                         const std::int64_t x,
+                                         const std::int64_t y,
+                                         const CellRegion& region,
+                                         std::vector<glm::i64vec2>& cells) const {
+        const auto& node = nodes_[id];
+        if (node.population == 0) {
+            return;
+        }
+
+        const auto size = std::int64_t{1} << node.level;
+        if (x > region.max.x || y > region.max.y || x + size <= region.min.x || y + size <= region.min.y) {
+            return;
+        }
+
+        if (node.level == 0) {
+            cells.emplace_back(x, y);
+            return;
+        }
+
+        const auto half = size / 2;
+        collect_cells(node.nw, x, y, region, cells);
+        collect_cells(node.ne, x + half, y, region, cells);
+        collect_cells(node.sw, x, y + half, region, cells);
+        collect_cells(node.se, x + half, y + half, region, cells);
+    }
+
+    void HashLifeUniverse::collect_density(const NodeId id,
+                                           const std::int64_t x,
+                                           const std::int64_t y,
+                                           const CellRegion& region,
+                                           const unsigned int shift,
+                                           std::vector<DensityBlock>& blocks) const {
+        const auto& node = nodes_[id];
+        if (node.population == 0) {
+            return;
+        }
+
+        const auto size = std::int64_t{1} << node.level;
+        if (x > region.max.x || y > region.max.y || x + size <= region.min.x || y + size <= region.min.y) {
+            return;
+        }
+
+        // An aligned node no larger than a block lies entirely inside one; only the root is not aligned
+        if (node.level <= shift && (x & (size - 1)) == 0 && (y & (size - 1)) == 0) {
+            blocks.push_back({{x >> shift, y >> shift}, node.population});
+            return;
+        }
+
+        const auto half = size / 2;
+        collect_density(node.nw, x, y, region, shift, blocks);
+        collect_density(node.ne, x + half, y, region, shift, blocks);
+        collect_density(node.sw, x, y + half, region, shift, blocks);
+        collect_density(node.se, x + half, y + half, region, shift, blocks);
+    }
+
+    void HashLifeUniverse::extend_bounds(const NodeId id,
+                                         const std::int64_t x,
+                                         const std::int64_t y,
+                                         CellRegion& bounds) const {
+        const auto& node = nodes_[id];
+        if (node.population == 0) {
+            return;
+        }
+
+        // A node inside the bounds found so far cannot widen them, which leaves only the nodes along the edges
+        const auto size = std::int64_t{1} << node.level;
+        if (!bounds.empty() && x >= bounds.min.x && y >= bounds.min.y &&
+            x + size - 1 <= bounds.max.x && y + size - 1 <= bounds.max.y) {
+            return;
+        }
+
+        if (node.level == 0) {
+            const glm::i64vec2 cell(x, y);
+            if (bounds.empty()) {
+                bounds = {cell, cell};
+            }
+            else {
+                bounds.min = glm::min(bounds.min, cell);
+                bounds.max = glm::max(bounds.max, cell);
+            }
+            return;
+        }
+
+        const auto half = size / 2;
+        extend_bounds(node.nw, x, y, bounds);
+        extend_bounds(node.ne, x + half, y, bounds);
+        extend_bounds(node.sw, x, y + half, bounds);
+        extend_bounds(node.se, x + half, y + half, bounds);
+    }
+
+    std::int64_t HashLifeUniverse::half_extent() const {
+        return std::int64_t{1} << (nodes_[root_].level - 1);
+    }
+
+    // Drops every node unreachable from the root together with all memoized results
+    void HashLifeUniverse::collect_garbage() {
+        const auto old_nodes = std::move(nodes_);
+
+        nodes_.clear();
+        index_.clear();
+        empty_nodes_.clear();
+        nodes_.push_back(old_nodes[DEAD_LEAF]);
+        nodes_.push_back(old_nodes[LIVE_LEAF]);
+
+        std::vector<NodeId> remap(old_nodes.size(), NO_NODE);
+        remap[DEAD_LEAF] = DEAD_LEAF;
+        remap[LIVE_LEAF] = LIVE_LEAF;
+        root_ = copy_reachable(root_, remap, old_nodes);
+
+        // Still mostly live after collecting: let the table grow before trying again
+        if (nodes_.size() > collect_threshold_ / 2) {
+            collect_threshold_ *= 2;
+        }
+    }
+
+    HashLifeUniverse::NodeId HashLifeUniverse::copy_reachable(const NodeId id,
+                                                              std::vector<NodeId>& remap,
+                                                              const std::vector<Node>& old_nodes) {
+        if (remap[id] != NO_NODE) {
+            return remap[id];
+        }
+
+        const auto& node = old_nodes[id];
+        const auto nw = copy_reachable(node.nw, remap, old_nodes);
+        const auto ne = copy_reachable(node.ne, remap, old_nodes);
+        const auto sw = copy_reachable(node.sw, remap, old_nodes);
+        const auto se = copy_reachable(node.se, remap, old_nodes);
+
+        remap[id] = join(nw, ne, sw, se);
+        return remap[id];
+    }
+}
@@ -0,0 +1,121 @@
+#include "golxx/hash_set_engine.h"
+
+namespace golxx {
+    namespace {
+        constexpr glm::i64vec2 NEIGHBOR_OFFSETS[] = {
+            {-1, -1}, {-1, 0}, {-1, 1},
+            {0, -1}, {0, 1},
+            {1, -1}, {1, 0}, {1, 1},
+        };
+    }
+
+    void HashSetEngine::set_state(const glm::i64vec2 cell, const bool state) {
+        if (state) {
+            cells_.insert(cell);
+        }
+        else {
+            cells_.erase(cell);
+        }
+    }
+
+    void HashSetEngine::set_cells(const std::vector<glm::i64vec2>& cells) {
+        cells_.reserve(cells_.size() + cells.size());
+        cells_.insert(cells.begin(), cells.end());
+    }
+
+    void HashSetEngine::clear() {
+        cells_.clear();
+        births_.clear();
+        deaths_.clear();
+    }
+
+    void HashSetEngine::step(const unsigned int exponent) {
+        for (std::uint64_t i = 0; i < std::uint64_t{1} << exponent; i++) {
+            step_generation();
+        }
+    }
+
+    CellRegion HashSetEngine::bounds() const {
+        if (cells_.empty()) {
+            return {};
+        }
+
+        CellRegion bounds{*cells_.begin(), *cells_.begin()};
+        for (const auto& cell : cells_) {
+            bounds.min = glm::min(bounds.min, cell);
+            bounds.max = glm::max(bounds.max, cell);
+        }
+        return bounds;
+    }
+
+    void HashSetEngine::collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const {
+        for (const auto& cell : cells_) {
+            if (region.contains(cell)) {
+                cells.push_back(cell);
+            }
+        }
+    }
+
+    void HashSetEngine::collect_density(const CellRegion& region, const unsigned int shift,
+                                        std::vector<DensityBlock>& blocks) const {
+        for (const auto& cell : cells_) {
+            if (region.contains(cell)) {
+                blocks.push_back({{cell.x >> shift, cell.y >> shift}, 1});
+            }
+        }
+    }
+
+    void HashSetEngine::fill_stats(GenerationStats& stats) const {
+        stats.births = births_.size();
+        stats.deaths = deaths_.size();
+        stats.bounds = bounds();
+        stats.memory_bytes = cells_.memory_usage() +
+            (births_.capacity() + deaths_.capacity()) * sizeof(glm::i64vec2);
+    }
+
+    void HashSetEngine::step_generation() {
+        births_.clear();
+        deaths_.clear();
+
+        for (const auto& cell : cells_) {
+            int count = 0;
+            for (const auto offset : NEIGHBOR_OFFSETS) {
+                const auto neighbor = cell + offset;
+                if (cells_.contains(neighbor)) {
+                    count++;
+                    continue;
+                }
+
+                // Dead cells can only be born next to a live one; each is judged once, from the first
+                // of its live neighbors in offset order
+                int neighbor_count = 0;
+                bool first = true;
+                for (const auto neighbor_offset : NEIGHBOR_OFFSETS) {
+                    const auto other = neighbor + neighbor_offset;
+                    if (cells_.contains(other)) {
+                        first = first && (neighbor_count > 0 || other == cell);
+                        neighbor_count++;
+                        if (!first) {
+                            break;
+                        }
+                    }
+                }
+
+                if (first && rule_.next_state(false, neighbor_count)) {
+                    births_.push_back(neighbor);
+                }
+            }
+
+            if (!rule_.next_state(true, count)) {
+                deaths_.push_back(cell);
+            }
+        }
+
+        for (const auto& cell : deaths_) {
+            cells_.erase(cell);
+        }
+        for (const auto& cell : births_) {
+            cells_.insert(cell);
+        }
+    }
+}
@@ -1,5 +1,8 @@
 #include "golxx/input.h"
 
+#include <bitset>
+#include <vector>
+
 namespace golxx {
     typedef struct {
         glfw::KeyCode code;
@@ -19,16 +22,43 @@ namespace golxx {
     glm::dvec2 cursor{};
     glm::dvec2 cursor_offset{};
 
-    std::map<glfw::KeyCode, bool> pressed_keys;
-    std::map<glfw::KeyCode, bool> up_keys;
-    std::map<glfw::KeyCode, bool> down_keys;
+    // Fixed-size state indexed by GLFW code, so polling and clearing never touch the heap
+    template <typename Code, std::size_t Count>
+    class ButtonStates {
+    public:
+        bool operator[](const Code code) const {
+            const auto index = static_cast<std::size_t>(code);
+            return index < Count && states_[index];
+        }
+
+        void set(const Code code, const bool state) {
+            if (const auto index = static_cast<std::size_t>(code); index < Count) {
+                states_[index] = state;
+            }
+        }
+
+        void clear() {
+            states_.reset();
+        }
+
+    private:
+        std::bitset<Count> states_;
+    };
+
+    using KeyStates = ButtonStates<glfw::KeyCode, GLFW_KEY_LAST + 1>;
+    using MouseButtonStates = ButtonStates<glfw::MouseButton, GLFW_MOUSE_BUTTON_LAST + 1>;
 
-    std::map<glfw::MouseButton, bool> pressed_mouse_buttons;
-    std::map<glfw::MouseButton, bool> up_mouse_buttons;
-    std::map<glfw::MouseButton, bool> down_mouse_buttons;
+    KeyStates pressed_keys;
+    KeyStates up_keys;
+    KeyStates down_keys;
 
-    std::queue<UnhandledKey> unhandled_keys;
-    std::queue<UnhandledMouseButton> unhandled_mouse_buttons;
+    MouseButtonStates pressed_mouse_buttons;
+    MouseButtonStates up_mouse_buttons;
+    MouseButtonStates down_mouse_buttons;
+
+    // Events arrive in callbacks during glfwPollEvents and are applied in Update; the vectors keep their capacity
+    std::vector<UnhandledKey> unhandled_keys;
+    std::vector<UnhandledMouseButton> unhandled_mouse_buttons;
 
     glm::vec2 current_mouse{};
     glm::vec2 last_mouse{};
@@ -76,33 +106,29 @@ namespace golxx {
         down_mouse_buttons.clear();
         up_mouse_buttons.clear();
 
-        while (!unhandled_keys.empty()) {
-            auto [code, action] = unhandled_keys.front();
-            unhandled_keys.pop();
-
+        for (const auto [code, action] : unhandled_keys) {
             if (action == glfw::KeyAction::Press) {
-                down_keys[code] = true;
-                pressed_keys[code] = true;
+                down_keys.set(code, true);
+                pressed_keys.set(code, true);
             }
             else if (action == glfw::KeyAction::Release) {
-                up_keys[code] = true;
-                pressed_keys[code] = false;
+                up_keys.set(code, true);
+                pressed_keys.set(code, false);
             }
         }
+        unhandled_keys.clear();
 
-        while (!unhandled_mouse_buttons.empty()) {
-            auto [code, action] = unhandled_mouse_buttons.front();
-            unhandled_mouse_buttons.pop();
-
+        for (const auto [code, action] : unhandled_mouse_buttons) {
             if (action == glfw::MouseButtonAction::Press) {
-                down_mouse_buttons[code] = true;
-                pressed_mouse_buttons[code] = true;
+                down_mouse_buttons.set(code, true);
+                pressed_mouse_buttons.set(code, true);
             }
             else if (action == glfw::MouseButtonAction::Release) {
-                up_mouse_buttons[code] = true;
-                pressed_mouse_buttons[code] = false;
+                up_mouse_buttons.set(code, true);
+                pressed_mouse_buttons.set(code, false);
             }
         }
+        unhandled_mouse_buttons.clear();
 
         offset_mouse = current_mouse - last_mouse;
         last_mouse = current_mouse;
@@ -123,11 +149,11 @@ namespace golxx {
     }
 
     void Input::HandleKey(const glfw::KeyCode code, const glfw::KeyAction action) {
-        unhandled_keys.push({code, action});
+        unhandled_keys.push_back({code, action});
     }
 
     void Input::HandleMouseButton(const glfw::MouseButton button, const glfw::MouseButtonAction action) {
-        unhandled_mouse_buttons.push({button, action});
+        unhandled_mouse_buttons.push_back({button, action});
     }
 
     void Input::HandleCursorPosition(const float x, const float y) {
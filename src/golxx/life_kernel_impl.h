@@ -0,0 +1,179 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// Shared body of the tile kernels. Each kernel translation unit is compiled for its own
+// instruction set and instantiates this with a word type of matching width, so it must
+// stay free of anything the linker could merge across units.
+namespace golxx {
+    namespace {
+        constexpr int KERNEL_TILE_ROWS = 64;
+
+        struct FixedRule {
+            std::uint16_t birth;
+            std::uint16_t survival;
+        };
+
+        // Rules with their own kernel: Conway, HighLife, Day & Night and Seeds.
+        // Every other rule runs through the generic kernel at index FIXED_RULE_COUNT.
+        constexpr FixedRule FIXED_RULES[] = {
+            {1 << 3, 1 << 2 | 1 << 3},
+            {1 << 3 | 1 << 6, 1 << 2 | 1 << 3},
+            {1 << 3 | 1 << 6 | 1 << 7 | 1 << 8, 1 << 3 | 1 << 4 | 1 << 6 | 1 << 7 | 1 << 8},
+            {1 << 2, 0},
+        };
+        constexpr int FIXED_RULE_COUNT = sizeof(FIXED_RULES) / sizeof(FIXED_RULES[0]);
+        constexpr int LIFE_KERNEL_COUNT = FIXED_RULE_COUNT + 1;
+
+        // Same signature as golxx::LifeRowsKernel, spelled out to keep this header self-contained
+        using RowsKernel = void (*)(const std::uint64_t* left,
+                                    const std::uint64_t* center,
+                                    const std::uint64_t* right,
+                                    std::uint64_t* out,
+                                    std::uint16_t birth,
+                                    std::uint16_t survival);
+
+        template <class Word>
+        inline Word load_rows(const std::uint64_t* rows) {
+            Word word;
+            std::memcpy(&word, rows, sizeof(Word));
+            return word;
+        }
+
+        template <class Word>
+        inline void full_add(const Word a, const Word b, const Word c, Word& sum, Word& carry) {
+            const Word partial = a ^ b;
+            sum = partial ^ c;
+            carry = (a & b) | (partial & c);
+        }
+
+        // Neighbor count as bits of weight 1, 2, 4 and 8, plus the cells themselves
+        template <class Word>
+        struct NeighborCount {
+            Word bits[4];
+            Word alive;
+
+            // Lanes where the count equals n
+            [[nodiscard]] Word equals(const int n) const {
+                Word match = ~Word{};
+                for (int bit = 0; bit < 4; bit++) {
+                    match &= (n >> bit & 1) ? bits[bit] : ~bits[bit];
+                }
+                return match;
+            }
+        };
+
+        template <class Word>
+        inline NeighborCount<Word> count_neighbors(const std::uint64_t* left,
+                                                   const std::uint64_t* center,
+                                                   const std::uint64_t* right) {
+            Word top_sum, top_carry;
+            full_add(load_rows<Word>(left), load_rows<Word>(center), load_rows<Word>(right), top_sum, top_carry);
+
+            const Word middle_left = load_rows<Word>(left + 1);
+            const Word middle_right = load_rows<Word>(right + 1);
+            const Word middle_sum = middle_left ^ middle_right;
+            const Word middle_carry = middle_left & middle_right;
+
+            Word bottom_sum, bottom_carry;
+            full_add(load_rows<Word>(left + 2), load_rows<Word>(center + 2), load_rows<Word>(right + 2),
+                     bottom_sum, bottom_carry);
+
+            NeighborCount<Word> count;
+            Word ones_carry;
+            full_add(top_sum, middle_sum, bottom_sum, count.bits[0], ones_carry);
+
+            Word twos, fours;
+            full_add(top_carry, middle_carry, bottom_carry, twos, fours);
+            count.bits[1] = twos ^ ones_carry;
+            const Word twos_carry = twos & ones_carry;
+            count.bits[2] = fours ^ twos_carry;
+            count.bits[3] = fours & twos_carry;
+
+            count.alive = load_rows<Word>(center + 1);
+            return count;
+        }
+
+        template <class Word, int Rule>
+        inline Word apply_fixed_rule(const NeighborCount<Word>& count) {
+            constexpr auto birth = FIXED_RULES[Rule].birth;
+            constexpr auto survival = FIXED_RULES[Rule].survival;
+
+            if constexpr (Rule == 0) {
+                // Conway by hand: exactly 3, or exactly 2 and alive
+                return count.bits[1] & ~count.bits[2] & ~count.bits[3] & (count.bits[0] | count.alive);
+            }
+            else {
+                // Masks are constants here, so the unused counts fold away
+                Word born{};
+                Word survived{};
+                for (int n = 0; n <= 8; n++) {
+                    if (birth >> n & 1) {
+                        born |= count.equals(n);
+                    }
+                    if (survival >> n & 1) {
+                        survived |= count.equals(n);
+                    }
+                }
+                return (born & ~count.alive) | (survived & count.alive);
+            }
+        }
+
+        template <class Word, int Rule>
+        void step_rows_fixed(const std::uint64_t* left,
+                             const std::uint64_t* center,
+                             const std::uint64_t* right,
+                             std::uint64_t* out,
+                             std::uint16_t,
+                             std::uint16_t) {
+            constexpr int lanes = sizeof(Word) / sizeof(std::uint64_t);
+
+            for (int y = 0; y < KERNEL_TILE_ROWS; y += lanes) {
+                const auto count = count_neighbors<Word>(left + y, center + y, right + y);
+                const Word next = apply_fixed_rule<Word, Rule>(count);
+                std::memcpy(out + y, &next, sizeof(Word));
+            }
+        }
+
+        template <class Word>
+        void step_rows_generic(const std::uint64_t* left,
+                               const std::uint64_t* center,
+                               const std::uint64_t* right,
+                               std::uint64_t* out,
+                               const std::uint16_t birth,
+                               const std::uint16_t survival) {
+            constexpr int lanes = sizeof(Word) / sizeof(std::uint64_t);
+
+            for (int y = 0; y < KERNEL_TILE_ROWS; y += lanes) {
+                const auto count = count_neighbors<Word>(left + y, center + y, right + y);
+
+                Word born{};
+                Word survived{};
+                for (int n = 0; n <= 8; n++) {
+                    const Word match = count.equals(n);
+                    if (birth >> n & 1) {
+                        born |= match;
+                    }
+                    if (survival >> n & 1) {
+                        survived |= match;
+                    }
+                }
+
+                const Word next = (born & ~count.alive) | (survived & count.alive);
+                std::memcpy(out + y, &next, sizeof(Word));
+            }
+        }
+
+        // Kernels indexed like FIXED_RULES, with the generic kernel last
+        template <class Word>
+        struct LifeKernelTable {
+            static constexpr RowsKernel kernels[LIFE_KERNEL_COUNT] = {
+                step_rows_fixed<Word, 0>,
+                step_rows_fixed<Word, 1>,
+                step_rows_fixed<Word, 2>,
+                step_rows_fixed<Word, 3>,
+                step_rows_generic<Word>,
+            };
+        };
+    }
+}
@@ -0,0 +1,57 @@
+#include "golxx/life_kernels.h"
+
+#include <iostream>
+#include "life_kernel_impl.h"
+
+namespace golxx {
+#if defined(GOLXX_X86_KERNELS)
+    const RowsKernel* life_kernels_sse2();
+    const RowsKernel* life_kernels_avx2();
+    const RowsKernel* life_kernels_avx512();
+#endif
+
+    namespace {
+        struct KernelSet {
+            const char* name;
+            const RowsKernel* kernels;
+        };
+
+        KernelSet select_kernel_set() {
+#if defined(GOLXX_X86_KERNELS)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return {"avx512", life_kernels_avx512()};
+            }
+            if (__builtin_cpu_supports("avx2")) {
+                return {"avx2", life_kernels_avx2()};
+            }
+            if (__builtin_cpu_supports("sse2")) {
+                return {"sse2", life_kernels_sse2()};
+            }
+#endif
+            return {"scalar", LifeKernelTable<std::uint64_t>::kernels};
+        }
+
+        const KernelSet& get_kernel_set() {
+            static const KernelSet kernel_set = [] {
+                const auto selected = select_kernel_set();
+                std::clog << "Simulation kernel: " << selected.name << '\n';
+                return selected;
+            }();
+
+            return kernel_set;
+        }
+    }
+
+    LifeKernel get_life_kernel(const LifeRule& rule) {
+        const auto& kernel_set = get_kernel_set();
+
+        for (int i = 0; i < FIXED_RULE_COUNT; i++) {
+            if (FIXED_RULES[i].birth == rule.birth && FIXED_RULES[i].survival == rule.survival) {
+                return {kernel_set.name, kernel_set.kernels[i]};
+            }
+        }
+
+        return {kernel_set.name, kernel_set.kernels[FIXED_RULE_COUNT]};
+    }
+}
@@ -0,0 +1,9 @@
+#include "life_kernel_impl.h"
+
+namespace golxx {
+    using AVX2Word = std::uint64_t __attribute__((vector_size(32)));
+
+    const RowsKernel* life_kernels_avx2() {
+        return LifeKernelTable<AVX2Word>::kernels;
+    }
+}
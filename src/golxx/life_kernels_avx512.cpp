@@ -0,0 +1,9 @@
+#include "life_kernel_impl.h"
+
+namespace golxx {
+    using AVX512Word = std::uint64_t __attribute__((vector_size(64)));
+
+    const RowsKernel* life_kernels_avx512() {
+        return LifeKernelTable<AVX512Word>::kernels;
+    }
+}
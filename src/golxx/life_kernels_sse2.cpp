@@ -0,0 +1,9 @@
+#include "life_kernel_impl.h"
+
+namespace golxx {
+    using SSE2Word = std::uint64_t __attribute__((vector_size(16)));
+
+    const RowsKernel* life_kernels_sse2() {
+        return LifeKernelTable<SSE2Word>::kernels;
+    }
+}
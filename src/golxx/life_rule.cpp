@@ -0,0 +1,75 @@
+#include "golxx/life_rule.h"
+
+#include <cctype>
+#include <stdexcept>
+
+namespace golxx {
+    namespace {
+        std::uint16_t parse_counts(const std::string& digits, const std::string& rule) {
+            std::uint16_t mask = 0;
+            for (const auto digit : digits) {
+                if (digit < '0' || digit > '8') {
+                    throw std::invalid_argument("Invalid neighbor count in rule: " + rule);
+                }
+                mask |= static_cast<std::uint16_t>(1 << (digit - '0'));
+            }
+            return mask;
+        }
+
+        std::string format_counts(const std::uint16_t mask) {
+            std::string digits;
+            for (int count = 0; count <= 8; count++) {
+                if (mask >> count & 1) {
+                    digits += static_cast<char>('0' + count);
+                }
+            }
+            return digits;
+        }
+    }
+
+    LifeRule LifeRule::parse(const std::string& text) {
+        std::string rule;
+        for (const auto c : text) {
+            if (!std::isspace(static_cast<unsigned char>(c))) {
+                rule += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            }
+        }
+
+        const auto slash = rule.find('/');
+        if (slash == std::string::npos || rule.find('/', slash + 1) != std::string::npos) {
+            throw std::invalid_argument("Rule must have the form B3/S23: " + text);
+        }
+
+        const auto first = rule.substr(0, slash);
+        const auto second = rule.substr(slash + 1);
+
+        LifeRule result{};
+        const auto prefixed = [](const std::string& part, const char prefix) {
+            return !part.empty() && part.front() == prefix;
+        };
+
+        if (prefixed(first, 'B') && prefixed(second, 'S')) {
+            result.birth = parse_counts(first.substr(1), text);
+            result.survival = parse_counts(second.substr(1), text);
+        }
+        else if (prefixed(first, 'S') && prefixed(second, 'B')) {
+            result.survival = parse_counts(first.substr(1), text);
+            result.birth = parse_counts(second.substr(1), text);
+        }
+        else {
+            // Legacy survival/birth notation
+            result.survival = parse_counts(first, text);
+            result.birth = parse_counts(second, text);
+        }
+
+        if (result.birth & 1) {
+            throw std::invalid_argument("B0 rules are not supported: " + text);
+        }
+
+        return result;
+    }
+
+    std::string LifeRule::to_string() const {
+        return "B" + format_counts(birth) + "/S" + format_counts(survival);
+    }
+}
@@ -0,0 +1,368 @@
+#include "golxx/pattern_io.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "golxx/file_extension.h"
+
+namespace golxx {
+    namespace {
+        // Cells handed to the simulator at a time while loading
+        constexpr std::size_t LOAD_BATCH = std::size_t{1} << 16;
+        constexpr std::size_t RLE_LINE_LENGTH = 70;
+
+        class CellBatch {
+        public:
+            explicit CellBatch(Simulator& simulator)
+                : simulator_(simulator) {
+                cells_.reserve(LOAD_BATCH);
+            }
+
+            void add(const std::int64_t x, const std::int64_t y) {
+                const glm::i64vec2 cell(x, y);
+                if (!in_cell_range(cell)) {
+                    throw std::runtime_error("Pattern exceeds the coordinate range");
+                }
+
+                cells_.push_back(cell);
+                if (cells_.size() == LOAD_BATCH) {
+                    flush();
+                }
+            }
+
+            void flush() {
+                if (!cells_.empty()) {
+                    simulator_.insert_cells(cells_);
+                    cells_.clear();
+                }
+            }
+
+        private:
+            Simulator& simulator_;
+            std::vector<glm::i64vec2> cells_;
+        };
+
+        // Decodes an RLE body one character at a time; row 0 is at origin_y and rows go down
+        class RleDecoder {
+        public:
+            RleDecoder(Simulator& simulator, const std::int64_t origin_x, const std::int64_t origin_y)
+                : batch_(simulator),
+                  origin_x_(origin_x),
+                  origin_y_(origin_y) {}
+
+            // Returns false once the closing '!' was read
+            bool feed(const char c) {
+                if (c >= '0' && c <= '9') {
+                    count_ = count_ * 10 + (c - '0');
+                    if (count_ > std::numeric_limits<int>::max()) {
+                        throw std::runtime_error("RLE run length is too long");
+                    }
+                    return true;
+                }
+                if (std::isspace(static_cast<unsigned char>(c))) {
+                    return true;
+                }
+
+                const auto run = count_ ? count_ : 1;
+                count_ = 0;
+
+                switch (c) {
+                case 'b':
+                case '.':
+                    x_ += run;
+                    break;
+                case '$':
+                    x_ = 0;
+                    row_ += run;
+                    break;
+                case '!':
+                    return false;
+                default:
+                    if (!std::isalpha(static_cast<unsigned char>(c))) {
+                        throw std::runtime_error(std::string("Unexpected character in RLE: ") + c);
+                    }
+
+                    // Under a two-state rule every state other than dead is alive
+                    for (std::int64_t i = 0; i < run; i++) {
+                        batch_.add(origin_x_ + x_ + i, origin_y_ - row_);
+                    }
+                    x_ += run;
+                    break;
+                }
+
+                return true;
+            }
+
+            void finish() {
+                batch_.flush();
+            }
+
+        private:
+            CellBatch batch_;
+            std::int64_t origin_x_;
+            std::int64_t origin_y_;
+            std::int64_t x_ = 0;
+            std::int64_t row_ = 0;
+            std::int64_t count_ = 0;
+        };
+
+        std::string trim(const std::string& text) {
+            const auto begin = text.find_first_not_of(" \t\r");
+            if (begin == std::string::npos) {
+                return "";
+            }
+            return text.substr(begin, text.find_last_not_of(" \t\r") - begin + 1);
+        }
+
+        void set_rule(Simulator& simulator, const std::string& rule) {
+            try {
+                simulator.set_rule(LifeRule::parse(rule));
+            } catch (const std::invalid_argument& e) {
+                throw std::runtime_error(std::string("Unsupported pattern rule: ") + e.what());
+            }
+        }
+
+        // "x = 3, y = 3, rule = B3/S23"; the size is only a hint, the body is decoded without it
+        void parse_rle_header(const std::string& line, Simulator& simulator) {
+            const auto rule = line.find("rule");
+            if (rule == std::string::npos) {
+                return;
+            }
+
+            const auto equals = line.find('=', rule);
+            if (equals == std::string::npos) {
+                throw std::runtime_error("Malformed RLE header: " + line);
+            }
+            set_rule(simulator, trim(line.substr(equals + 1)));
+        }
+
+        // "#CXRLE Pos=x,y" gives the top-left corner with y going down, "#r" a rule in the old S/B notation
+        void parse_rle_comment(const std::string& line, Simulator& simulator,
+                               std::int64_t& origin_x, std::int64_t& origin_y) {
+            if (line.rfind("#CXRLE", 0) == 0) {
+                if (const auto pos = line.find("Pos="); pos != std::string::npos) {
+                    std::istringstream stream(line.substr(pos + 4));
+                    std::int64_t x = 0;
+                    std::int64_t y = 0;
+                    char comma = 0;
+                    if (!(stream >> x >> comma >> y) || comma != ',') {
+                        throw std::runtime_error("Malformed RLE position: " + line);
+                    }
+                    // y goes down in the file, so the top row is -y; the same range write_rle produces
+                    if (y == std::numeric_limits<std::int64_t>::min() || !in_cell_range({x, -y})) {
+                        throw std::runtime_error("Pattern exceeds the coordinate range");
+                    }
+                    origin_x = x;
+                    origin_y = -y;
+                }
+            }
+            else if (line.rfind("#r", 0) == 0) {
+                set_rule(simulator, trim(line.substr(2)));
+            }
+        }
+
+        // Top row first, left to right
+        std::vector<glm::i64vec2> sorted_cells(const Simulator& simulator) {
+            std::vector<glm::i64vec2> cells;
+            simulator.collect_cells(simulator.bounds(), cells);
+            std::sort(cells.begin(), cells.end(), [](const glm::i64vec2 a, const glm::i64vec2 b) {
+                return a.y != b.y ? a.y > b.y : a.x < b.x;
+            });
+            return cells;
+        }
+
+        std::int64_t min_column(const std::vector<glm::i64vec2>& cells) {
+            auto min_x = cells.front().x;
+            for (const auto& cell : cells) {
+                min_x = std::min(min_x, cell.x);
+            }
+            return min_x;
+        }
+    }
+
+    void load_pattern(const std::string& filename, Simulator& simulator) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open pattern: " + filename);
+        }
+
+        if (has_extension(filename, ".rle")) {
+            read_rle(file, simulator);
+        }
+        else {
+            read_plaintext(file, simulator);
+        }
+    }
+
+    void save_pattern(const std::string& filename, const Simulator& simulator) {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to write pattern: " + filename);
+        }
+
+        if (has_extension(filename, ".rle")) {
+            write_rle(file, simulator);
+        }
+        else {
+            write_plaintext(file, simulator);
+        }
+
+        if (!file) {
+            throw std::runtime_error("Failed to write pattern: " + filename);
+        }
+    }
+
+    void read_plaintext(std::istream& in, Simulator& simulator) {
+        CellBatch batch(simulator);
+
+        std::string line;
+        std::int64_t y = 0;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.front() == '!') {
+                continue;
+            }
+
+            for (std::size_t x = 0; x < line.size(); x++) {
+                if (line[x] == 'O' || line[x] == '*') {
+                    batch.add(static_cast<std::int64_t>(x), y);
+                }
+            }
+            y--;
+        }
+
+        batch.flush();
+        if (in.bad()) {
+            throw std::runtime_error("Failed to read pattern");
+        }
+    }
+
+    void write_plaintext(std::ostream& out, const Simulator& simulator) {
+        out << "!Generation: " << simulator.getGeneration() << '\n';
+        out << "!Rule: " << simulator.getRule().to_string() << '\n';
+
+        const auto cells = sorted_cells(simulator);
+        if (cells.empty()) {
+            return;
+        }
+
+        const auto min_x = min_column(cells);
+        auto row = cells.front().y;
+        auto column = min_x;
+        for (const auto& cell : cells) {
+            for (; row > cell.y; row--) {
+                out << '\n';
+                column = min_x;
+            }
+            out << std::string(cell.x - column, '.') << 'O';
+            column = cell.x + 1;
+        }
+        out << '\n';
+    }
+
+    void read_rle(std::istream& in, Simulator& simulator) {
+        std::int64_t origin_x = 0;
+        std::int64_t origin_y = 0;
+
+        // Comments and the header are short lines and read whole; the body may be arbitrarily long, even on
+        // one line, and is streamed from its first character
+        std::string line;
+        for (auto c = in.peek(); c != std::istream::traits_type::eof(); c = in.peek()) {
+            if (std::isspace(c)) {
+                in.get();
+                continue;
+            }
+            if (c != '#' && c != 'x') {
+                break;
+            }
+
+            std::getline(in, line);
+            const auto text = trim(line);
+            if (c == '#') {
+                parse_rle_comment(text, simulator, origin_x, origin_y);
+                continue;
+            }
+            parse_rle_header(text, simulator);
+            break;
+        }
+
+        RleDecoder decoder(simulator, origin_x, origin_y);
+
+        auto* buffer = in.rdbuf();
+        for (bool open = true; open;) {
+            const auto c = buffer->sbumpc();
+            if (c == std::istream::traits_type::eof()) {
+                break;
+            }
+            open = decoder.feed(static_cast<char>(c));
+        }
+
+        decoder.finish();
+        if (in.bad()) {
+            throw std::runtime_error("Failed to read pattern");
+        }
+    }
+
+    void write_rle(std::ostream& out, const Simulator& simulator) {
+        const auto cells = sorted_cells(simulator);
+        const auto rule = simulator.getRule().to_string();
+        if (cells.empty()) {
+            out << "x = 0, y = 0, rule = " << rule << "\n!\n";
+            return;
+        }
+
+        const auto min_x = min_column(cells);
+        auto max_x = min_x;
+        for (const auto& cell : cells) {
+            max_x = std::max(max_x, cell.x);
+        }
+        const auto top = cells.front().y;
+        const auto bottom = cells.back().y;
+
+        out << "#CXRLE Pos=" << min_x << ',' << -top << '\n';
+        out << "x = " << max_x - min_x + 1 << ", y = " << top - bottom + 1 << ", rule = " << rule << '\n';
+
+        std::size_t line_length = 0;
+        const auto put = [&](const std::int64_t run, const char tag) {
+            const auto token = run > 1 ? std::to_string(run) + tag : std::string(1, tag);
+            if (line_length + token.size() > RLE_LINE_LENGTH) {
+                out << '\n';
+                line_length = 0;
+            }
+            out << token;
+            line_length += token.size();
+        };
+
+        // Dead cells at the end of a row are implied by '$'
+        auto row = top;
+        auto column = min_x;
+        for (std::size_t i = 0; i < cells.size();) {
+            const auto cell = cells[i];
+            if (cell.y != row) {
+                put(row - cell.y, '$');
+                row = cell.y;
+                column = min_x;
+            }
+            if (cell.x > column) {
+                put(cell.x - column, 'b');
+            }
+
+            auto end = i + 1;
+            while (end < cells.size() && cells[end].y == cell.y && cells[end].x == cells[end - 1].x + 1) {
+                end++;
+            }
+
+            const auto run = static_cast<std::int64_t>(end - i);
+            put(run, 'o');
+            column = cell.x + run;
+            i = end;
+        }
+
+        put(1, '!');
+        out << '\n';
+    }
+}
@@ -1,4 +1,5 @@
 #include "golxx/player.h"
+#include <cstdlib>
 #include "golxx/input.h"
 
 namespace golxx {
@@ -22,10 +23,10 @@ namespace golxx {
     }
 
     Player::Player(const std::shared_ptr<Camera>& camera,
-                   const std::shared_ptr<Simulator>& simulator,
+                   const std::shared_ptr<SimulationWorker>& simulation_worker,
                    const float speed)
         : camera_(camera),
-          simulator_(simulator),
+          simulation_worker_(simulation_worker),
           speed_(speed) {}
 
     void Player::update(const float deltaTime) {
@@ -50,15 +51,14 @@ namespace golxx {
             camera_->position += glm::vec3(offset.x, offset.y, 0.0f);
         }
 
-        const auto current_cell = glm::ivec2(
-            static_cast<int>(std::floor(cursorWorldPos.x)),
-            static_cast<int>(std::floor(cursorWorldPos.y)));
+        camera_->rebase();
+        const auto current_cell = camera_->cursor_to_cell(Input::GetCursorPosition());
 
         if (Input::GetMouseButtonDown(glfw::MouseButton::Left)) {
             is_drawing_line_ = true;
             last_cell_ = current_cell;
-            drawing_state_ = simulator_->getCells().find(current_cell) == simulator_->getCells().end();
-            simulator_->set_state(current_cell, drawing_state_);
+            drawing_state_ = !simulation_worker_->getSnapshot()->contains(current_cell);
+            simulation_worker_->set_state(current_cell, drawing_state_);
         }
         else if (Input::GetMouseButtonUp(glfw::MouseButton::Left)) {
             is_drawing_line_ = false;
@@ -69,20 +69,20 @@ namespace golxx {
         }
     }
 
-    void Player::toggle_line_cells(const glm::ivec2 from, const glm::ivec2 to, const bool toggle) {
-        const int dx = abs(to.x - from.x);
-        const int dy = -abs(to.y - from.y);
-        const int sx = from.x < to.x ? 1 : -1;
-        const int sy = from.y < to.y ? 1 : -1;
-        int err = dx + dy;
+    void Player::toggle_line_cells(const glm::i64vec2 from, const glm::i64vec2 to, const bool toggle) {
+        const std::int64_t dx = std::abs(to.x - from.x);
+        const std::int64_t dy = -std::abs(to.y - from.y);
+        const std::int64_t sx = from.x < to.x ? 1 : -1;
+        const std::int64_t sy = from.y < to.y ? 1 : -1;
+        auto err = dx + dy;
 
-        glm::ivec2 current = from;
+        glm::i64vec2 current = from;
         while (true) {
-            simulator_->set_state(current, toggle);
+            simulation_worker_->set_state(current, toggle);
 
             if (current == to) break;
 
-            const int e2 = 2 * err;
+            const auto e2 = 2 * err;
             if (e2 >= dy) {
                 err += dy;
                 current.x += sx;
@@ -0,0 +1,96 @@
+#include "golxx/simulation_engine.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include "golxx/bit_tile_universe.h"
+#include "golxx/hash_life_universe.h"
+#include "golxx/hash_set_engine.h"
+#include "golxx/sorted_cell_engine.h"
+
+namespace golxx {
+    SimulationEngineType parse_simulation_engine(const std::string& name) {
+        if (name == "hashset") {
+            return SimulationEngineType::HashSet;
+        }
+        if (name == "bittile") {
+            return SimulationEngineType::BitTile;
+        }
+        if (name == "hashlife") {
+            return SimulationEngineType::HashLife;
+        }
+        if (name == "sorted") {
+            return SimulationEngineType::SortedCells;
+        }
+        throw std::invalid_argument("Unknown simulation engine: " + name);
+    }
+
+    const char* to_string(const SimulationEngineType engine) {
+        switch (engine) {
+        case SimulationEngineType::HashSet:
+            return "hashset";
+        case SimulationEngineType::BitTile:
+            return "bittile";
+        case SimulationEngineType::HashLife:
+            return "hashlife";
+        case SimulationEngineType::SortedCells:
+            return "sorted";
+        }
+        return "unknown";
+    }
+
+    void SimulationEngine::visit_tiles(const CellRegion& region, const std::uint64_t stamp,
+                                       const TileVisitor& visit) const {
+        tile_cells_.clear();
+        collect_cells(region, tile_cells_);
+
+        const auto tile_of = [](const glm::i64vec2 cell) {
+            return glm::i64vec2(cell.x >> CellTile::SHIFT, cell.y >> CellTile::SHIFT);
+        };
+        std::sort(tile_cells_.begin(), tile_cells_.end(), [&](const glm::i64vec2 a, const glm::i64vec2 b) {
+            const auto tile_a = tile_of(a);
+            const auto tile_b = tile_of(b);
+            return tile_a.y != tile_b.y ? tile_a.y < tile_b.y : tile_a.x < tile_b.x;
+        });
+
+        constexpr int MASK = CellTile::SIZE - 1;
+        std::array<std::uint64_t, CellTile::SIZE> rows{};
+        for (std::size_t i = 0; i < tile_cells_.size(); i++) {
+            const auto cell = tile_cells_[i];
+            rows[cell.y & MASK] |= std::uint64_t{1} << (cell.x & MASK);
+
+            const auto key = tile_of(cell);
+            if (i + 1 == tile_cells_.size() || tile_of(tile_cells_[i + 1]) != key) {
+                visit(key, stamp, rows);
+                rows.fill(0);
+            }
+        }
+    }
+
+    void SimulationEngine::collect_tiles(const CellRegion& region, const std::uint64_t stamp,
+                                         std::vector<CellTile>& tiles) const {
+        visit_tiles(region, stamp, [&](const glm::i64vec2 key, const std::uint64_t tile_stamp,
+                                       const std::array<std::uint64_t, CellTile::SIZE>& rows) {
+            tiles.push_back({key, tile_stamp, rows});
+        });
+    }
+
+    std::unique_ptr<SimulationEngine> make_simulation_engine(const SimulationEngineType type, ThreadPool* pool) {
+        switch (type) {
+        case SimulationEngineType::HashSet:
+            return std::make_unique<HashSetEngine>();
+        case SimulationEngineType::BitTile: {
+            auto tiles = std::make_unique<BitTileUniverse>();
+            tiles->set_thread_pool(pool);
+            return tiles;
+        }
+        case SimulationEngineType::HashLife:
+            return std::make_unique<HashLifeUniverse>();
+        case SimulationEngineType::SortedCells: {
+            auto sorted = std::make_unique<SortedCellEngine>();
+            sorted->set_thread_pool(pool);
+            return sorted;
+        }
+        }
+        throw std::invalid_argument("Unknown simulation engine");
+    }
+}
@@ -0,0 +1,318 @@
+#include "golxx/simulation_worker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include "golxx/allocation_tracker.h"
+#include "golxx/trace_recorder.h"
+
+namespace golxx {
+    namespace {
+        // Any live cell shows; brightness follows the square root of the density so sparse blocks stay visible
+        std::uint8_t density_shade(const std::uint64_t population, const unsigned int shift) {
+            if (population == 0) {
+                return 0;
+            }
+
+            const auto density = static_cast<double>(population) / std::ldexp(1.0, static_cast<int>(2 * shift));
+            return static_cast<std::uint8_t>(std::min(32.0 + 223.0 * std::sqrt(density), 255.0));
+        }
+
+        std::size_t bitmap_index(const CellRegion& blocks, const glm::i64vec2 block) {
+            const auto width = static_cast<std::size_t>(blocks.max.x - blocks.min.x + 1);
+            return static_cast<std::size_t>(block.y - blocks.min.y) * width + (block.x - blocks.min.x);
+        }
+    }
+
+    bool SimulationSnapshot::contains(const glm::i64vec2 cell) const {
+        if (format == SnapshotFormat::Bitmap) {
+            if (!region.contains(cell)) {
+                return false;
+            }
+            return bitmap[bitmap_index(bitmap_blocks(), {cell.x >> block_shift, cell.y >> block_shift})] != 0;
+        }
+        if (format == SnapshotFormat::Tiles) {
+            if (!region.contains(cell)) {
+                return false;
+            }
+
+            const glm::i64vec2 key(cell.x >> CellTile::SHIFT, cell.y >> CellTile::SHIFT);
+            const auto tile = std::find_if(tiles.begin(), tiles.end(), [&](const CellTile& t) { return t.key == key; });
+            constexpr int MASK = CellTile::SIZE - 1;
+            return tile != tiles.end() && (tile->rows[cell.y & MASK] >> (cell.x & MASK) & 1);
+        }
+
+        return std::find(cells.begin(), cells.end(), cell) != cells.end();
+    }
+
+    unsigned int SimulationSnapshot::bitmap_shift(const CellRegion& region) {
+        unsigned int shift = 0;
+        while (shift < 62) {
+            const auto blocks = region.blocks(shift);
+            if (blocks.max.x - blocks.min.x < MAX_BITMAP_SIZE && blocks.max.y - blocks.min.y < MAX_BITMAP_SIZE) {
+                break;
+            }
+            shift++;
+        }
+        return shift;
+    }
+
+    SimulationWorker::SimulationWorker(const std::shared_ptr<Simulator>& simulator,
+                                       const float generations_per_second)
+        : simulator_(simulator),
+          step_interval_(generations_per_second > 0.0f
+                             ? std::chrono::duration_cast<Clock::duration>(
+                                 std::chrono::duration<double>(1.0 / generations_per_second))
+                             : Clock::duration::zero()),
+          snapshot_(std::make_shared<SimulationSnapshot>()) {
+        publish_snapshot();
+        thread_ = std::thread(&SimulationWorker::run, this);
+    }
+
+    SimulationWorker::~SimulationWorker() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        thread_.join();
+    }
+
+    void SimulationWorker::set_running(const bool running) {
+        {
+            std::lock_guard lock(mutex_);
+            if (running_ == running) {
+                return;
+            }
+            running_ = running;
+        }
+        wake_.notify_all();
+    }
+
+    void SimulationWorker::request_step() {
+        {
+            std::lock_guard lock(mutex_);
+            pending_steps_++;
+        }
+        wake_.notify_all();
+    }
+
+    void SimulationWorker::set_state(const glm::i64vec2 cell, const bool state) {
+        {
+            std::lock_guard lock(mutex_);
+            pending_edits_.push_back({cell, state});
+        }
+        wake_.notify_all();
+    }
+
+    void SimulationWorker::submit(Task task) {
+        {
+            std::lock_guard lock(mutex_);
+            pending_tasks_.push_back(std::move(task));
+        }
+        wake_.notify_all();
+    }
+
+    void SimulationWorker::set_view(const CellRegion& region, const SnapshotFormat format) {
+        bool wake = false;
+        {
+            std::lock_guard lock(mutex_);
+            if (view_region_ == region && view_format_ == format) {
+                return;
+            }
+            view_region_ = region;
+            view_format_ = format;
+            snapshot_stale_ = true;
+            wake = snapshot_requested_;
+        }
+
+        if (wake) {
+            wake_.notify_all();
+        }
+    }
+
+    std::shared_ptr<const SimulationSnapshot> SimulationWorker::getSnapshot() {
+        bool wake = false;
+        std::shared_ptr<const SimulationSnapshot> snapshot;
+        {
+            std::lock_guard lock(mutex_);
+            snapshot = snapshot_;
+            if (!snapshot_requested_) {
+                snapshot_requested_ = true;
+                wake = snapshot_stale_;
+            }
+        }
+
+        if (wake) {
+            wake_.notify_all();
+        }
+        return snapshot;
+    }
+
+    void SimulationWorker::run() {
+        // Whatever the simulation thread allocates counts against the step
+        AllocationScope allocation_scope(FramePhase::Step);
+        TraceRecorder::get().set_thread_name("simulation");
+        auto next_step = Clock::now();
+
+        while (true) {
+            bool step = false;
+            bool publish = false;
+            {
+                std::unique_lock lock(mutex_);
+                const auto has_work = [&] {
+                    return stopping_ || pending_steps_ > 0 || !pending_edits_.empty() || !pending_tasks_.empty() ||
+                        (snapshot_stale_ && snapshot_requested_);
+                };
+
+                if (running_) {
+                    wake_.wait_until(lock, next_step, [&] { return has_work() || !running_; });
+                }
+                else {
+                    wake_.wait(lock, [&] { return has_work() || running_; });
+                    next_step = Clock::now();
+                }
+
+                if (stopping_) {
+                    return;
+                }
+
+                std::swap(applied_edits_, pending_edits_);
+                std::swap(applied_tasks_, pending_tasks_);
+
+                if (pending_steps_ > 0) {
+                    pending_steps_--;
+                    step = true;
+                }
+                else if (running_ && Clock::now() >= next_step) {
+                    step = true;
+                    // Fall behind rather than burst when a generation takes longer than the interval
+                    next_step = std::max(next_step + step_interval_, Clock::now());
+                }
+            }
+
+            // A failing edit or task is reported and skipped; letting it escape would end the whole program
+            for (const auto& [cell, state] : applied_edits_) {
+                try {
+                    simulator_->set_state(cell, state);
+                } catch (const std::exception& e) {
+                    std::cerr << "Edit failed: " << e.what() << '\n';
+                }
+            }
+
+            for (const auto& task : applied_tasks_) {
+                try {
+                    task(*simulator_);
+                } catch (const std::exception& e) {
+                    std::cerr << "Simulation task failed: " << e.what() << '\n';
+                }
+            }
+
+            if (step) {
+                simulator_->run_cycle();
+            }
+
+            {
+                std::lock_guard lock(mutex_);
+                snapshot_stale_ |= step || !applied_edits_.empty() || !applied_tasks_.empty();
+                publish = snapshot_stale_ && snapshot_requested_;
+                if (publish) {
+                    snapshot_stale_ = false;
+                    snapshot_requested_ = false;
+                }
+            }
+            applied_edits_.clear();
+            applied_tasks_.clear();
+
+            if (publish) {
+                publish_snapshot();
+            }
+        }
+    }
+
+    std::shared_ptr<SimulationSnapshot> SimulationWorker::acquire_snapshot() {
+        for (const auto& snapshot : snapshot_pool_) {
+            if (snapshot.use_count() == 1) {
+                // Pairs with the release in the last reader's reference drop
+                std::atomic_thread_fence(std::memory_order_acquire);
+                snapshot->population = 0;
+                snapshot->block_shift = 0;
+                snapshot->cells.clear();
+                snapshot->bitmap.clear();
+                snapshot->tiles.clear();
+                return snapshot;
+            }
+        }
+
+        return snapshot_pool_.emplace_back(std::make_shared<SimulationSnapshot>());
+    }
+
+    void SimulationWorker::publish_snapshot() {
+        auto snapshot = acquire_snapshot();
+        snapshot->generation = simulator_->getGeneration();
+        {
+            std::lock_guard lock(mutex_);
+            snapshot->region = view_region_;
+            snapshot->format = view_format_;
+        }
+
+        const auto& region = snapshot->region;
+        if (snapshot->format == SnapshotFormat::Bitmap && !region.empty()) {
+            const auto shift = SimulationSnapshot::bitmap_shift(region);
+            const auto blocks = region.blocks(shift);
+            snapshot->block_shift = shift;
+            snapshot->bitmap.assign(blocks.area(), 0);
+
+            if (shift == 0) {
+                region_cells_.clear();
+                simulator_->collect_cells(region, region_cells_);
+                for (const auto cell : region_cells_) {
+                    snapshot->bitmap[bitmap_index(blocks, cell)] = 255;
+                }
+                snapshot->population = region_cells_.size();
+            }
+            else {
+                region_blocks_.clear();
+                simulator_->collect_density(region, shift, region_blocks_);
+
+                // Populations of a repeated block add up before it is shaded
+                std::sort(region_blocks_.begin(), region_blocks_.end(), [](const DensityBlock& a, const DensityBlock& b) {
+                    return a.block.y != b.block.y ? a.block.y < b.block.y : a.block.x < b.block.x;
+                });
+
+                snapshot->population = 0;
+                for (std::size_t i = 0; i < region_blocks_.size();) {
+                    const auto block = region_blocks_[i].block;
+                    std::uint64_t population = 0;
+                    for (; i < region_blocks_.size() && region_blocks_[i].block == block; i++) {
+                        population += region_blocks_[i].population;
+                    }
+
+                    if (blocks.contains(block)) {
+                        snapshot->bitmap[bitmap_index(blocks, block)] = density_shade(population, shift);
+                        snapshot->population += population;
+                    }
+                }
+            }
+        }
+        else if (snapshot->format == SnapshotFormat::Tiles) {
+            simulator_->collect_tiles(region, snapshot->tiles);
+            for (const auto& tile : snapshot->tiles) {
+                for (const auto row : tile.rows) {
+                    snapshot->population += std::bitset<64>(row).count();
+                }
+            }
+        }
+        else {
+            snapshot->format = SnapshotFormat::Cells;
+            simulator_->collect_cells(region, snapshot->cells);
+            snapshot->population = snapshot->cells.size();
+        }
+
+        std::lock_guard lock(mutex_);
+        snapshot_ = std::move(snapshot);
+    }
+}
@@ -1,52 +1,166 @@
 #include "golxx/simulator.h"
-#include <unordered_map>
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include "golxx/frame_profiler.h"
+#include "golxx/trace_recorder.h"
 
 namespace golxx {
-    void Simulator::set_state(const glm::ivec2 cell, const bool state) {
-        if (state) {
-            cells_.insert(cell);
+    Simulator::Simulator(const SimulationEngineType engine, const unsigned int thread_count)
+        : pool_(std::make_unique<ThreadPool>(thread_count)),
+          engine_(make_simulation_engine(engine, pool_.get())) {}
+
+    void Simulator::collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const {
+        engine_->collect_cells(region, cells);
+    }
+
+    void Simulator::collect_density(const CellRegion& region, const unsigned int shift,
+                                    std::vector<DensityBlock>& blocks) const {
+        engine_->collect_density(region, shift, blocks);
+    }
+
+    void Simulator::collect_tiles(const CellRegion& region, std::vector<CellTile>& tiles) const {
+        engine_->collect_tiles(region, version_, tiles);
+    }
+
+    void Simulator::set_engine(const SimulationEngineType type) {
+        if (type == engine_->getType()) {
+            return;
         }
-        else {
-            cells_.erase(cell);
+
+        migrated_cells_.clear();
+        engine_->collect_cells(engine_->bounds(), migrated_cells_);
+
+        // The renderer keeps tiles by stamp across engines, so the new engine stamps above both old counts
+        version_ = std::max(version_, engine_->getLastStamp());
+        auto engine = make_simulation_engine(type, pool_.get());
+        engine->set_stamp_base(version_);
+        engine->set_rule(rule_);
+        engine->set_cells(migrated_cells_);
+        engine_ = std::move(engine);
+        version_++;
+    }
+
+    void Simulator::set_auto_engine(const bool enabled) {
+        auto_engine_ = enabled;
+        engine_selector_.reset();
+    }
+
+    void Simulator::set_step_exponent(const unsigned int exponent) {
+        step_exponent_ = std::min(exponent, MAX_STEP_EXPONENT);
+    }
+
+    void Simulator::set_rule(const LifeRule& rule) {
+        rule_ = rule;
+        engine_->set_rule(rule_);
+    }
+
+    void Simulator::set_state(const glm::i64vec2 cell, const bool state) {
+        if (!in_cell_range(cell)) {
+            throw std::invalid_argument("Cell is outside the coordinate range");
         }
+        version_++;
+        engine_->set_state(cell, state);
+    }
+
+    void Simulator::insert_cells(const std::vector<glm::i64vec2>& cells) {
+        if (!std::all_of(cells.begin(), cells.end(), in_cell_range)) {
+            throw std::invalid_argument("Cell is outside the coordinate range");
+        }
+        version_++;
+        engine_->set_cells(cells);
+    }
+
+    void Simulator::clear() {
+        version_++;
+        engine_->clear();
+        engine_selector_.reset();
+        generation_ = 0;
     }
 
     void Simulator::run_cycle() {
-        std::unordered_set<glm::ivec2> nextCells{};
-        std::unordered_map<glm::ivec2, int> neighborCounts{};
-
-        const std::vector<glm::ivec2> neighborOffsets = {
-            {-1, -1}, {-1, 0}, {-1, 1},
-            {0, -1}, {0, 1},
-            {1, -1}, {1, 0}, {1, 1}
-        };
-
-        // Calculate neighbor counts for all relevant cells
-        for (const auto& cell : cells_) {
-            for (const auto& offset : neighborOffsets) {
-                glm::ivec2 neighbor = cell + offset;
-                neighborCounts[neighbor]++;
-            }
+        select_engine(std::uint64_t{1} << step_exponent_);
+        cycle();
+    }
+
+    void Simulator::cycle() {
+        ProfileScope scope(FramePhase::Step);
+        version_++;
+        step(step_exponent_);
+    }
+
+    void Simulator::select_engine(const std::uint64_t generations_ahead) {
+        if (!auto_engine_) {
+            return;
         }
 
-        // Apply Conway's Game of Life rules
-        for (const auto& [cell, count] : neighborCounts) {
-            if (cells_.find(cell) != cells_.end()) {
-                // Live cell with 2 or 3 neighbors survives
-                if (count == 2 || count == 3) {
-                    nextCells.insert(cell);
-                }
-                // Otherwise it dies (underpopulation or overpopulation)
-            }
-            else {
-                // Dead cell with exactly 3 neighbors becomes alive
-                if (count == 3) {
-                    nextCells.insert(cell);
-                }
+        const auto type = engine_selector_.sample(*engine_, generation_, generations_ahead);
+        if (!type) {
+            return;
+        }
+
+        std::clog << "Switching engine from " << to_string(engine_->getType()) << " to " << to_string(*type)
+                  << " at generation " << generation_ << ": " << engine_selector_.getReason() << '\n';
+        set_engine(*type);
+    }
+
+    void Simulator::advance(std::uint64_t generations) {
+        const auto step_exponent = step_exponent_;
+
+        // Jumping engines take the largest power of two left each time; the others step one by one
+        while (generations > 0) {
+            select_engine(generations);
+
+            unsigned int exponent = 0;
+            while (exponent < engine_->getMaxStepExponent() && generations >> (exponent + 1) != 0) {
+                exponent++;
             }
+
+            step_exponent_ = exponent;
+            cycle();
+            generations -= std::uint64_t{1} << exponent;
         }
 
-        cells_ = std::move(nextCells);
-        generation_++;
+        step_exponent_ = step_exponent;
+    }
+
+    void Simulator::step(const unsigned int exponent) {
+        const auto generations = std::uint64_t{1} << exponent;
+
+        // Engines that jump do so in one step; stepping the others generation by generation lets every
+        // generation be traced and reported
+        if (engine_->getMaxStepExponent() > 0) {
+            TraceScope trace("generations", "sim");
+            trace.set_arg("exponent", exponent);
+            const auto start = Clock::now();
+            engine_->step(exponent);
+            generation_ += generations;
+            publish_stats(generations, start);
+            return;
+        }
+
+        for (std::uint64_t i = 0; i < generations; i++) {
+            TraceScope trace("generation", "sim");
+            trace.set_arg("generation", static_cast<std::int64_t>(generation_));
+            const auto start = Clock::now();
+            engine_->step(0);
+            generation_++;
+            publish_stats(1, start);
+        }
+    }
+
+    void Simulator::publish_stats(const std::uint64_t generations, const Clock::time_point start) {
+        if (!stats_callback_) {
+            return;
+        }
+
+        GenerationStats stats;
+        stats.step_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        stats.generation = generation_;
+        stats.generations = generations;
+        stats.population = engine_->population();
+        engine_->fill_stats(stats);
+
+        stats_callback_(stats);
     }
 }
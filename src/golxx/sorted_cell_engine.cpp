@@ -0,0 +1,369 @@
+#include "golxx/sorted_cell_engine.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include "golxx/trace_recorder.h"
+
+namespace golxx {
+    namespace {
+        // Row bounds of the first and last chunk, so that together the chunks cover every row
+        constexpr std::int64_t FIRST_ROW = std::numeric_limits<std::int64_t>::min();
+        constexpr std::int64_t END_ROW = std::numeric_limits<std::int64_t>::max();
+
+        // The list's order: bottom row first, left to right within a row
+        bool row_order(const glm::i64vec2 a, const glm::i64vec2 b) {
+            return a.y != b.y ? a.y < b.y : a.x < b.x;
+        }
+
+        // The first cell at or above row y
+        template <typename It>
+        It find_row(const It first, const It last, const std::int64_t y) {
+            return std::lower_bound(first, last, y, [](const glm::i64vec2 cell, const std::int64_t row) {
+                return cell.y < row;
+            });
+        }
+
+        // A cell and its eight neighbors
+        constexpr std::size_t NEIGHBORHOOD_SIZE = 9;
+
+        constexpr unsigned int RADIX_BITS = 11;
+        constexpr std::size_t RADIX_MIN_KEYS = 256;
+
+        unsigned int bit_width(std::uint64_t value) {
+            unsigned int bits = 0;
+            for (; value != 0; value >>= 1) {
+                bits++;
+            }
+            return bits;
+        }
+
+        // LSD radix sort of the low key_bits bits of keys[0, count), bouncing between keys and scratch.
+        // Returns whichever buffer ends up sorted.
+        std::uint64_t* radix_sort(std::uint64_t* keys, std::uint64_t* scratch, const std::size_t count,
+                                  const unsigned int key_bits) {
+            // Clearing the histograms costs more than the passes save on a handful of keys
+            if (count < RADIX_MIN_KEYS) {
+                std::sort(keys, keys + count);
+                return keys;
+            }
+
+            constexpr std::uint64_t DIGIT_MASK = (std::uint64_t{1} << RADIX_BITS) - 1;
+            std::array<std::size_t, std::size_t{1} << RADIX_BITS> histogram{};
+            for (unsigned int shift = 0; shift < key_bits; shift += RADIX_BITS) {
+                histogram.fill(0);
+                for (std::size_t i = 0; i < count; i++) {
+                    histogram[(keys[i] >> shift) & DIGIT_MASK]++;
+                }
+
+                std::size_t offset = 0;
+                for (auto& bucket : histogram) {
+                    const auto size = bucket;
+                    bucket = offset;
+                    offset += size;
+                }
+                for (std::size_t i = 0; i < count; i++) {
+                    const auto key = keys[i];
+                    scratch[histogram[(key >> shift) & DIGIT_MASK]++] = key;
+                }
+                std::swap(keys, scratch);
+            }
+            return keys;
+        }
+
+        // Walks the sorted neighborhood keys alongside the live cells, both in the same order, and calls
+        // fn(key, alive, neighbors) once per distinct key. A live cell's own key is taken off its count.
+        template <typename Key, typename It, typename Encode, typename Less, typename Fn>
+        void count_runs(const Key* keys, const std::size_t count, It live, const It live_end, const Encode& encode,
+                        const Less& less, const Fn& fn) {
+            auto live_key = encode(*live);
+            for (std::size_t i = 0; i < count;) {
+                const auto key = keys[i];
+                const auto run_begin = i;
+                while (i < count && keys[i] == key) {
+                    i++;
+                }
+
+                while (live != live_end && less(live_key, key)) {
+                    if (++live != live_end) {
+                        live_key = encode(*live);
+                    }
+                }
+                const auto alive = live != live_end && live_key == key;
+                fn(key, alive, static_cast<int>(i - run_begin) - alive);
+            }
+        }
+
+        // Calls fn with every live cell in region, skipping whole stretches of rows outside its columns
+        template <typename Fn>
+        void for_each_in(const std::vector<glm::i64vec2>& cells, const CellRegion& region, Fn&& fn) {
+            if (region.empty()) {
+                return;
+            }
+
+            auto it = std::lower_bound(cells.begin(), cells.end(), region.min, row_order);
+            while (it != cells.end() && !row_order(region.max, *it)) {
+                const auto cell = *it;
+                if (cell.x < region.min.x) {
+                    it = std::lower_bound(it, cells.end(), glm::i64vec2(region.min.x, cell.y), row_order);
+                    continue;
+                }
+                if (cell.x > region.max.x) {
+                    if (cell.y == region.max.y) {
+                        break;
+                    }
+                    it = std::lower_bound(it, cells.end(), glm::i64vec2(region.min.x, cell.y + 1), row_order);
+                    continue;
+                }
+                fn(cell);
+                ++it;
+            }
+        }
+    }
+
+    void SortedCellEngine::set_state(const glm::i64vec2 cell, const bool state) {
+        const auto it = std::lower_bound(cells_.begin(), cells_.end(), cell, row_order);
+        const auto present = it != cells_.end() && *it == cell;
+        if (state && !present) {
+            cells_.insert(it, cell);
+        }
+        else if (!state && present) {
+            cells_.erase(it);
+        }
+    }
+
+    void SortedCellEngine::set_cells(const std::vector<glm::i64vec2>& cells) {
+        const auto old_size = cells_.size();
+        cells_.insert(cells_.end(), cells.begin(), cells.end());
+
+        const auto middle = cells_.begin() + static_cast<std::ptrdiff_t>(old_size);
+        std::sort(middle, cells_.end(), row_order);
+        std::inplace_merge(cells_.begin(), middle, cells_.end(), row_order);
+        cells_.erase(std::unique(cells_.begin(), cells_.end()), cells_.end());
+    }
+
+    void SortedCellEngine::clear() {
+        cells_.clear();
+        births_ = 0;
+        deaths_ = 0;
+    }
+
+    void SortedCellEngine::step(const unsigned int exponent) {
+        for (std::uint64_t i = 0; i < std::uint64_t{1} << exponent; i++) {
+            step_generation();
+        }
+    }
+
+    CellRegion SortedCellEngine::bounds() const {
+        if (cells_.empty()) {
+            return {};
+        }
+
+        // Rows come straight from the ends of the list, columns need a pass
+        CellRegion bounds{cells_.front(), cells_.back()};
+        for (const auto cell : cells_) {
+            bounds.min.x = std::min(bounds.min.x, cell.x);
+            bounds.max.x = std::max(bounds.max.x, cell.x);
+        }
+        return bounds;
+    }
+
+    void SortedCellEngine::collect_cells(const CellRegion& region, std::vector<glm::i64vec2>& cells) const {
+        for_each_in(cells_, region, [&](const glm::i64vec2 cell) {
+            cells.push_back(cell);
+        });
+    }
+
+    void SortedCellEngine::collect_density(const CellRegion& region, const unsigned int shift,
+                                           std::vector<DensityBlock>& blocks) const {
+        const auto first = blocks.size();
+        for_each_in(cells_, region, [&](const glm::i64vec2 cell) {
+            const glm::i64vec2 block{cell.x >> shift, cell.y >> shift};
+            if (blocks.size() > first && blocks.back().block == block) {
+                blocks.back().population++;
+            }
+            else {
+                blocks.push_back({block, 1});
+            }
+        });
+    }
+
+    void SortedCellEngine::fill_stats(GenerationStats& stats) const {
+        stats.births = births_;
+        stats.deaths = deaths_;
+        stats.bounds = bounds();
+
+        auto cells = cells_.capacity() + next_cells_.capacity();
+        std::size_t keys = 0;
+        for (const auto& chunk : chunks_) {
+            cells += chunk.cells.capacity();
+        }
+        for (const auto& workspace : workspaces_) {
+            keys += workspace.keys.capacity() + workspace.scratch.capacity();
+            cells += workspace.cells.capacity();
+        }
+        stats.memory_bytes = cells * sizeof(glm::i64vec2) + keys * sizeof(std::uint64_t) +
+            chunks_.capacity() * sizeof(Chunk) + workspaces_.capacity() * sizeof(Workspace);
+    }
+
+    void SortedCellEngine::step_generation() {
+        // Chunks start at the rows of every CHUNK_CELLS-th cell; a row holding more than that is one chunk
+        const auto chunk_count = std::max<std::size_t>(1, (cells_.size() + CHUNK_CELLS - 1) / CHUNK_CELLS);
+        if (chunks_.size() < chunk_count) {
+            chunks_.resize(chunk_count);
+        }
+        for (std::size_t i = 0; i < chunk_count; i++) {
+            chunks_[i].first_row = i == 0 ? FIRST_ROW : cells_[i * CHUNK_CELLS].y;
+            chunks_[i].end_row = i + 1 == chunk_count ? END_ROW : cells_[(i + 1) * CHUNK_CELLS].y;
+        }
+
+        // Chunks hold the same number of cells, so dealing them out round robin balances the workers
+        const auto workers = pool_ ? std::min<std::size_t>(pool_->getThreadCount(), chunk_count) : 1;
+        if (workspaces_.size() < workers) {
+            workspaces_.resize(workers);
+        }
+        const auto step_workers = [&](const std::size_t begin, const std::size_t end) {
+            for (auto worker = begin; worker < end; worker++) {
+                for (auto i = worker; i < chunk_count; i += workers) {
+                    step_chunk(chunks_[i], workspaces_[worker]);
+                }
+            }
+        };
+
+        if (workers > 1) {
+            pool_->parallel_for(workers, 1, step_workers);
+        }
+        else {
+            step_workers(0, 1);
+        }
+
+        next_cells_.clear();
+        births_ = 0;
+        deaths_ = 0;
+        for (std::size_t i = 0; i < chunk_count; i++) {
+            const auto& chunk = chunks_[i];
+            next_cells_.insert(next_cells_.end(), chunk.cells.begin(), chunk.cells.end());
+            births_ += chunk.births;
+            deaths_ += chunk.deaths;
+        }
+        cells_.swap(next_cells_);
+    }
+
+    void SortedCellEngine::step_chunk(Chunk& chunk, Workspace& workspace) const {
+        TraceScope trace("sort_chunk", "sim");
+
+        // Every live cell on the chunk's rows and the one either side of them
+        const auto source_begin = chunk.first_row == FIRST_ROW
+                                      ? cells_.begin()
+                                      : find_row(cells_.begin(), cells_.end(), chunk.first_row - 1);
+        const auto source_end = chunk.end_row == END_ROW
+                                    ? cells_.end()
+                                    : find_row(source_begin, cells_.end(), chunk.end_row + 1);
+        trace.set_arg("cells", static_cast<std::int64_t>(source_end - source_begin));
+
+        chunk.cells.clear();
+        chunk.births = 0;
+        chunk.deaths = 0;
+
+        // Rows more than two apart share no neighbors, so the bands of rows between such gaps step on their own
+        for (auto band_begin = source_begin; band_begin != source_end;) {
+            auto band_end = band_begin + 1;
+            while (band_end != source_end && band_end->y <= (band_end - 1)->y + 2) {
+                ++band_end;
+            }
+            step_band(chunk, workspace, band_begin, band_end);
+            band_begin = band_end;
+        }
+    }
+
+    void SortedCellEngine::step_band(Chunk& chunk, Workspace& workspace, const CellIterator begin,
+                                     const CellIterator end) const {
+        // Keys are rebased on the corner of the band and only as wide as the band is, which spares the
+        // radix sort the passes over bits no key differs in
+        auto min_x = begin->x;
+        auto max_x = min_x;
+        for (auto it = begin; it != end; ++it) {
+            min_x = std::min(min_x, it->x);
+            max_x = std::max(max_x, it->x);
+        }
+        const auto base_x = min_x - 1;
+        const auto base_y = begin->y - 1;
+        const auto x_bits = bit_width(static_cast<std::uint64_t>(max_x - base_x + 1));
+        const auto y_bits = bit_width(static_cast<std::uint64_t>((end - 1)->y - base_y + 1));
+
+        // Each live cell counts itself too; its run is told apart from a dead cell's by the live list.
+        // Rows the chunk does not own are left to the chunk that does.
+        const auto owns = [&](const std::int64_t y) {
+            return y >= chunk.first_row && y < chunk.end_row;
+        };
+        const auto judge = [&](const glm::i64vec2 cell, const bool alive, const int neighbors) {
+            if (rule_.next_state(alive, neighbors)) {
+                chunk.cells.push_back(cell);
+                chunk.births += !alive;
+            }
+            else {
+                chunk.deaths += alive;
+            }
+        };
+
+        const auto capacity = static_cast<std::size_t>(end - begin) * NEIGHBORHOOD_SIZE;
+
+        // Cells far apart on the same rows can need more than 64 bits between them; such bands sort the
+        // cells themselves
+        if (x_bits + y_bits > 64) {
+            if (workspace.cells.size() < capacity) {
+                workspace.cells.resize(capacity);
+            }
+
+            auto* cells = workspace.cells.data();
+            std::size_t count = 0;
+            for (auto it = begin; it != end; ++it) {
+                for (int dy = -1; dy <= 1; dy++) {
+                    const auto y = it->y + dy;
+                    if (owns(y)) {
+                        cells[count++] = {it->x - 1, y};
+                        cells[count++] = {it->x, y};
+                        cells[count++] = {it->x + 1, y};
+                    }
+                }
+            }
+
+            std::sort(cells, cells + count, row_order);
+            count_runs(cells, count, begin, end, [](const glm::i64vec2 cell) { return cell; }, row_order, judge);
+            return;
+        }
+
+        const auto row_step = std::uint64_t{1} << x_bits;
+        const auto encode = [&](const glm::i64vec2 cell) {
+            return static_cast<std::uint64_t>(cell.y - base_y) << x_bits | static_cast<std::uint64_t>(cell.x - base_x);
+        };
+
+        if (workspace.keys.size() < capacity) {
+            workspace.keys.resize(capacity);
+            workspace.scratch.resize(capacity);
+        }
+
+        auto* keys = workspace.keys.data();
+        std::size_t count = 0;
+        for (auto it = begin; it != end; ++it) {
+            const auto key = encode(*it);
+            for (int dy = -1; dy <= 1; dy++) {
+                if (owns(it->y + dy)) {
+                    const auto center = key + static_cast<std::uint64_t>(dy) * row_step;
+                    keys[count++] = center - 1;
+                    keys[count++] = center;
+                    keys[count++] = center + 1;
+                }
+            }
+        }
+
+        const auto* sorted = radix_sort(keys, workspace.scratch.data(), count, x_bits + y_bits);
+        count_runs(sorted, count, begin, end, encode, std::less<std::uint64_t>(),
+                   [&](const std::uint64_t key, const bool alive, const int neighbors) {
+                       const glm::i64vec2 cell(base_x + static_cast<std::int64_t>(key & (row_step - 1)),
+                                               base_y + static_cast<std::int64_t>(key >> x_bits));
+                       judge(cell, alive, neighbors);
+                   });
+    }
+}
@@ -0,0 +1,133 @@
+#include "golxx/thread_pool.h"
+
+#include <algorithm>
+#include <string>
+#include "golxx/trace_recorder.h"
+
+namespace golxx {
+    ThreadPool::ThreadPool(unsigned int thread_count) {
+        if (thread_count == 0) {
+            thread_count = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (unsigned int i = 0; i < thread_count; i++) {
+            queues_.push_back(std::make_unique<WorkQueue>());
+        }
+
+        // Queue 0 belongs to the thread calling parallel_for
+        for (unsigned int i = 1; i < thread_count; i++) {
+            threads_.emplace_back(&ThreadPool::worker_loop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::parallel_for(const std::size_t count, std::size_t grain, const RangeFunction& fn) {
+        if (count == 0) {
+            return;
+        }
+
+        grain = std::max<std::size_t>(grain, 1);
+        const auto chunks = (count + grain - 1) / grain;
+        if (threads_.empty() || chunks == 1) {
+            fn(0, count);
+            return;
+        }
+
+        {
+            std::lock_guard lock(mutex_);
+            job_ = &fn;
+            remaining_ = chunks;
+
+            // Deal out contiguous runs of chunks so neighboring tiles start on the same thread
+            const auto thread_count = queues_.size();
+            for (std::size_t queue = 0; queue < thread_count; queue++) {
+                const auto first = chunks * queue / thread_count;
+                const auto last = chunks * (queue + 1) / thread_count;
+
+                std::lock_guard queue_lock(queues_[queue]->mutex);
+                queues_[queue]->ranges.clear();
+                queues_[queue]->front = 0;
+                for (auto chunk = first; chunk < last; chunk++) {
+                    queues_[queue]->ranges.push_back({chunk * grain, std::min(count, (chunk + 1) * grain)});
+                }
+            }
+
+            job_id_++;
+        }
+        wake_.notify_all();
+
+        while (run_one(0)) {}
+
+        std::unique_lock lock(mutex_);
+        done_.wait(lock, [this] { return remaining_ == 0; });
+        job_ = nullptr;
+    }
+
+    void ThreadPool::worker_loop(const unsigned int index) {
+        TraceRecorder::get().set_thread_name("pool " + std::to_string(index));
+        std::uint64_t seen_job = 0;
+
+        while (true) {
+            {
+                std::unique_lock lock(mutex_);
+                wake_.wait(lock, [&] { return stopping_ || job_id_ != seen_job; });
+                if (stopping_) {
+                    return;
+                }
+                seen_job = job_id_;
+            }
+
+            while (run_one(index)) {}
+        }
+    }
+
+    bool ThreadPool::run_one(const unsigned int index) {
+        Range range{};
+        if (!pop_range(index, range)) {
+            return false;
+        }
+
+        (*job_)(range.begin, range.end);
+
+        if (remaining_.fetch_sub(1) == 1) {
+            std::lock_guard lock(mutex_);
+            done_.notify_all();
+        }
+        return true;
+    }
+
+    bool ThreadPool::pop_range(const unsigned int index, Range& range) {
+        {
+            auto& own = *queues_[index];
+            std::lock_guard lock(own.mutex);
+            if (own.ranges.size() > own.front) {
+                range = own.ranges.back();
+                own.ranges.pop_back();
+                return true;
+            }
+        }
+
+        const auto thread_count = static_cast<unsigned int>(queues_.size());
+        for (unsigned int offset = 1; offset < thread_count; offset++) {
+            auto& victim = *queues_[(index + offset) % thread_count];
+            std::lock_guard lock(victim.mutex);
+            if (victim.ranges.size() > victim.front) {
+                range = victim.ranges[victim.front++];
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
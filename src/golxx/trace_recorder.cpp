@@ -0,0 +1,107 @@
+#include "golxx/trace_recorder.h"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace golxx {
+    namespace {
+        constexpr std::size_t RESERVED_EVENTS = std::size_t{1} << 16;
+
+        std::atomic<std::uint32_t> next_thread_id{0};
+    }
+
+    TraceRecorder& TraceRecorder::get() {
+        static TraceRecorder instance;
+        return instance;
+    }
+
+    std::uint32_t TraceRecorder::thread_id() {
+        thread_local const auto id = next_thread_id.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    void TraceRecorder::start(const std::string& filename) {
+        std::lock_guard lock(mutex_);
+        events_.clear();
+        events_.reserve(RESERVED_EVENTS);
+        filename_ = filename;
+        origin_ = Clock::now();
+        recording_.store(true, std::memory_order_relaxed);
+    }
+
+    void TraceRecorder::stop() {
+        std::vector<Event> events;
+        std::vector<std::string> thread_names;
+        Clock::time_point origin;
+        {
+            std::lock_guard lock(mutex_);
+            if (!recording()) {
+                return;
+            }
+            recording_.store(false, std::memory_order_relaxed);
+            events.swap(events_);
+            thread_names = thread_names_;
+            origin = origin_;
+        }
+
+        std::ofstream out(filename_);
+        if (!out.is_open()) {
+            throw std::runtime_error("Failed to write trace: " + filename_);
+        }
+
+        const auto microseconds = [origin](const Clock::time_point time) {
+            return std::chrono::duration<double, std::micro>(time - origin).count();
+        };
+
+        out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+        bool first = true;
+        for (std::size_t thread = 0; thread < thread_names.size(); thread++) {
+            if (thread_names[thread].empty()) {
+                continue;
+            }
+            out << (first ? "" : ",\n")
+                << R"({"name": "thread_name", "ph": "M", "pid": 1, "tid": )" << thread
+                << R"(, "args": {"name": ")" << thread_names[thread] << "\"}}";
+            first = false;
+        }
+
+        out.setf(std::ios::fixed);
+        out.precision(3);
+        for (const auto& event : events) {
+            out << (first ? "" : ",\n")
+                << R"({"name": ")" << event.name << R"(", "cat": ")" << event.category
+                << R"(", "ph": "X", "pid": 1, "tid": )" << event.thread
+                << ", \"ts\": " << microseconds(event.start)
+                << ", \"dur\": " << microseconds(event.end) - microseconds(event.start);
+            if (event.arg_name) {
+                out << R"(, "args": {")" << event.arg_name << "\": " << event.arg << '}';
+            }
+            out << '}';
+            first = false;
+        }
+        out << "\n]}\n";
+
+        if (!out) {
+            throw std::runtime_error("Failed to write trace: " + filename_);
+        }
+    }
+
+    void TraceRecorder::set_thread_name(const std::string& name) {
+        const auto id = thread_id();
+        std::lock_guard lock(mutex_);
+        if (thread_names_.size() <= id) {
+            thread_names_.resize(id + 1);
+        }
+        thread_names_[id] = name;
+    }
+
+    void TraceRecorder::add_span(const char* name, const char* category, const Clock::time_point start,
+                                 const Clock::time_point end, const char* arg_name, const std::int64_t arg) {
+        const auto thread = thread_id();
+        std::lock_guard lock(mutex_);
+        // A span that began before the recording stopped and ended after is dropped
+        if (recording()) {
+            events_.push_back({name, category, start, end, thread, arg_name, arg});
+        }
+    }
+}
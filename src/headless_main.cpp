@@ -0,0 +1,189 @@
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+#include "golxx/generation_stats.h"
+#include "golxx/life_rule.h"
+#include "golxx/pattern_io.h"
+#include "golxx/simulator.h"
+#include "golxx/trace_recorder.h"
+
+// Runs a pattern for a number of generations without a window or GL context.
+namespace {
+    struct HeadlessOptions {
+        std::string input;
+        std::string output;
+        std::string stats = "-";
+        std::string trace;
+        std::string generation_stats;
+        std::uint64_t generations = 0;
+        golxx::SimulationEngineType engine = golxx::SimulationEngineType::BitTile;
+        // Starts on the tile engine and lets the simulator switch
+        bool auto_engine = false;
+        unsigned int threads = 0;
+        // Overrides the rule stored in the pattern file when set
+        std::optional<golxx::LifeRule> rule;
+    };
+
+    void print_usage(const char* program) {
+        std::cout << "Usage: " << program << " --input <pattern> --generations <n> [options]\n"
+                  << "  --input <file>        Pattern to load (.rle or .cells)\n"
+                  << "  --generations <n>     Generations to run\n"
+                  << "  --engine <name>       hashset, bittile, hashlife, sorted or auto (default: bittile)\n"
+                  << "  --threads <n>         Simulation threads, 0 for all hardware threads (default: 0)\n"
+                  << "  --rule <rule>         Life-like rule in B/S notation (default: the pattern's, else B3/S23)\n"
+                  << "  --output <file>       Write the final pattern (.rle or .cells)\n"
+                  << "  --stats <file>        Write run statistics as JSON, - for stdout (default: -)\n"
+                  << "  --trace <file>        Record the run as a Chrome trace (chrome://tracing, Perfetto)\n"
+                  << "  --generation-stats <file>\n"
+                  << "                        Write statistics of every generation, as NDJSON for .ndjson\n"
+                  << "                        and .jsonl files, else CSV\n";
+    }
+
+    std::uint64_t parse_count(const std::string& option, const std::string& value) {
+        try {
+            std::size_t end = 0;
+            const auto count = std::stoull(value, &end);
+            if (end == value.size() && value.front() != '-') {
+                return count;
+            }
+        } catch (const std::exception&) {}
+
+        throw std::invalid_argument("Invalid value for " + option + ": " + value);
+    }
+
+    HeadlessOptions parse_arguments(const int argc, char** argv) {
+        HeadlessOptions options;
+        bool has_generations = false;
+
+        for (int i = 1; i < argc; i++) {
+            const std::string option = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + option);
+            }
+            const std::string value = argv[++i];
+
+            if (option == "--input") {
+                options.input = value;
+            }
+            else if (option == "--output") {
+                options.output = value;
+            }
+            else if (option == "--stats") {
+                options.stats = value;
+            }
+            else if (option == "--trace") {
+                options.trace = value;
+            }
+            else if (option == "--generation-stats") {
+                options.generation_stats = value;
+            }
+            else if (option == "--generations") {
+                options.generations = parse_count(option, value);
+                has_generations = true;
+            }
+            else if (option == "--engine") {
+                options.auto_engine = value == "auto";
+                if (!options.auto_engine) {
+                    options.engine = golxx::parse_simulation_engine(value);
+                }
+            }
+            else if (option == "--threads") {
+                options.threads = static_cast<unsigned int>(parse_count(option, value));
+            }
+            else if (option == "--rule") {
+                options.rule = golxx::LifeRule::parse(value);
+            }
+            else {
+                throw std::invalid_argument("Unknown option: " + option);
+            }
+        }
+
+        if (options.input.empty() || !has_generations) {
+            throw std::invalid_argument("--input and --generations are required");
+        }
+
+        return options;
+    }
+
+    void write_stats(std::ostream& out, const HeadlessOptions& options, const golxx::Simulator& simulator,
+                     const std::uint64_t initial_population, const double seconds) {
+        out << "{\n"
+            << "  \"engine\": \"" << golxx::to_string(simulator.getEngineType()) << "\",\n"
+            << "  \"threads\": " << simulator.getThreadCount() << ",\n"
+            << "  \"rule\": \"" << simulator.getRule().to_string() << "\",\n"
+            << "  \"generations\": " << options.generations << ",\n"
+            << "  \"initial_population\": " << initial_population << ",\n"
+            << "  \"population\": " << simulator.getPopulation() << ",\n"
+            << "  \"seconds\": " << seconds << ",\n"
+            << "  \"generations_per_second\": " << (seconds > 0.0 ? options.generations / seconds : 0.0) << "\n"
+            << "}\n";
+    }
+}
+
+int main(const int argc, char** argv) {
+    if (argc == 2 && (std::string(argv[1]) == "--help" || std::string(argv[1]) == "-h")) {
+        print_usage(argv[0]);
+        return 0;
+    }
+
+    try {
+        const auto options = parse_arguments(argc, argv);
+
+        golxx::Simulator simulator(options.engine, options.threads);
+        simulator.set_auto_engine(options.auto_engine);
+        golxx::load_pattern(options.input, simulator);
+        if (options.rule) {
+            simulator.set_rule(*options.rule);
+        }
+
+        std::unique_ptr<golxx::GenerationStatsWriter> generation_stats;
+        if (!options.generation_stats.empty()) {
+            generation_stats = std::make_unique<golxx::GenerationStatsWriter>(options.generation_stats);
+            simulator.set_stats_callback([&generation_stats](const golxx::GenerationStats& stats) {
+                generation_stats->write(stats);
+            });
+        }
+
+        auto& trace = golxx::TraceRecorder::get();
+        if (!options.trace.empty()) {
+            trace.set_thread_name("main");
+            trace.start(options.trace);
+        }
+
+        const auto initial_population = simulator.getPopulation();
+        const auto start = std::chrono::steady_clock::now();
+        simulator.advance(options.generations);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        trace.stop();
+
+        if (!options.output.empty()) {
+            golxx::save_pattern(options.output, simulator);
+        }
+
+        if (options.stats == "-") {
+            write_stats(std::cout, options, simulator, initial_population, elapsed.count());
+        }
+        else {
+            std::ofstream stats(options.stats);
+            if (!stats.is_open()) {
+                throw std::runtime_error("Failed to write stats: " + options.stats);
+            }
+            write_stats(stats, options, simulator, initial_population, elapsed.count());
+        }
+    } catch (const std::invalid_argument& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        print_usage(argv[0]);
+        return -1;
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal error: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
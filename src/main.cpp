@@ -1,19 +1,44 @@
 #include <iostream>
+#include <string>
 
 #include "golxx/application.h"
 #include "golxx/engine.h"
 #include "golxx/game.h"
+#include "golxx/trace_recorder.h"
 
 constexpr unsigned int WIDTH = 800;
 constexpr unsigned int HEIGHT = 800;
 
-int main() {
+// Usage: golxx [--engine hashset | bittile | hashlife | sorted | auto] [--trace trace.json] [pattern.rle | pattern.cells]
+// --engine overrides the engine in config.json
+// --trace records a Chrome trace from the start until exit, or until F2 stops it
+int main(const int argc, char** argv) {
+    std::string engine_name;
+    std::string trace_file;
+    std::string pattern_file;
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        if (arg == "--engine" && i + 1 < argc) {
+            engine_name = argv[++i];
+        }
+        else if (arg == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+        }
+        else {
+            pattern_file = arg;
+        }
+    }
+
     try {
         golxx::Application application(WIDTH, HEIGHT, "Golxx");
         golxx::Engine engine;
-        golxx::Game game(application, engine);
+        golxx::Game game(application, engine, pattern_file, engine_name);
 
+        if (!trace_file.empty()) {
+            golxx::TraceRecorder::get().start(trace_file);
+        }
         game.run();
+        golxx::TraceRecorder::get().stop();
     } catch (const std::exception& e) {
         std::cerr << "Fatal error: " << e.what() << std::endl;
         return -1;